@@ -0,0 +1,109 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/support/BitOps.h"
+#include "tweedledum/support/DynamicBitset.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fmt/format.h>
+#include <random>
+#include <vector>
+
+// Times the bulk bit operations with each instruction set the CPU supports,
+// on operands from 1k to 1M bits, and reports the speedup over scalar code.
+
+using namespace tweedledum;
+
+namespace {
+
+char const* isa_name(SimdIsa isa)
+{
+	switch (isa) {
+	case SimdIsa::avx512:
+		return "avx512";
+	case SimdIsa::avx2:
+		return "avx2";
+	default:
+		return "scalar";
+	}
+}
+
+// Returns the average time, in nanoseconds, of one call to `fn`.
+template<typename Fn>
+double time_ns(uint32_t num_bits, Fn&& fn)
+{
+	uint32_t const repetitions = std::max(16u, (1u << 28) / num_bits);
+	auto const start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < repetitions; ++i) {
+		fn();
+	}
+	auto const end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count()
+	       / repetitions;
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937_64 rng(0x5eed);
+	std::vector<SimdIsa> isas = {SimdIsa::scalar};
+	if (simd_isa_supported() >= SimdIsa::avx2) {
+		isas.push_back(SimdIsa::avx2);
+	}
+	if (simd_isa_supported() >= SimdIsa::avx512) {
+		isas.push_back(SimdIsa::avx512);
+	}
+
+	fmt::print("{:>10} {:>10} {:>8} {:>12} {:>8}\n", "operation", "bits",
+	    "isa", "ns/op", "speedup");
+	for (uint32_t num_bits = 1024u; num_bits <= (1u << 20); num_bits <<= 2) {
+		DynamicBitset<uint64_t> a(num_bits);
+		DynamicBitset<uint64_t> b(num_bits);
+		for (uint32_t i = 0; i < num_bits; ++i) {
+			a.set(i, rng() & 1);
+			b.set(i, rng() & 1);
+		}
+		// Keeps the compiler from discarding the results
+		volatile std::size_t sink = 0;
+		auto const operations = {
+		    std::make_pair("xor", +[](DynamicBitset<uint64_t>& x,
+		                              DynamicBitset<uint64_t> const& y) {
+			    x ^= y;
+			    return std::size_t(0);
+		    }),
+		    std::make_pair("and", +[](DynamicBitset<uint64_t>& x,
+		                              DynamicBitset<uint64_t> const& y) {
+			    x &= y;
+			    return std::size_t(0);
+		    }),
+		    std::make_pair("count", +[](DynamicBitset<uint64_t>& x,
+		                                DynamicBitset<uint64_t> const&) {
+			    return x.count();
+		    }),
+		    std::make_pair("any", +[](DynamicBitset<uint64_t>& x,
+		                              DynamicBitset<uint64_t> const&) {
+			    return std::size_t(x.any());
+		    }),
+		};
+		for (auto const& [name, operation] : operations) {
+			double scalar_ns = 0.0;
+			for (SimdIsa isa : isas) {
+				set_simd_isa(isa);
+				DynamicBitset<uint64_t> x = a;
+				double const ns = time_ns(num_bits,
+				    [&]() { sink = sink + operation(x, b); });
+				if (isa == SimdIsa::scalar) {
+					scalar_ns = ns;
+				}
+				fmt::print("{:>10} {:>10} {:>8} {:>12.1f} {:>7.2f}x\n",
+				    name, num_bits, isa_name(isa), ns,
+				    scalar_ns / ns);
+			}
+		}
+	}
+	set_simd_isa(simd_isa_supported());
+	return 0;
+}
@@ -0,0 +1,73 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/support/WalshHadamard.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fmt/format.h>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Times the fast Walsh-Hadamard transform of 2^16 to 2^26 doubles: textbook
+// triple loop, and the blocked transform on one and on all hardware threads.
+
+using namespace tweedledum;
+
+namespace {
+
+void textbook_transform(std::vector<double>& values)
+{
+	for (std::size_t m = 1u; m < values.size(); m <<= 1) {
+		for (std::size_t i = 0u; i < values.size(); i += (m << 1)) {
+			for (std::size_t j = i; j < i + m; ++j) {
+				double const t = values[j];
+				values[j] += values[j + m];
+				values[j + m] = t - values[j + m];
+			}
+		}
+	}
+}
+
+template<typename Fn>
+double time_ms(Fn&& fn)
+{
+	auto const start = std::chrono::steady_clock::now();
+	fn();
+	auto const end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+} // namespace
+
+int main()
+{
+	std::mt19937_64 rng(0x5eed);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	uint32_t const num_threads = std::thread::hardware_concurrency();
+	fmt::print("{:>6} {:>12} {:>12} {:>12} (threads: {})\n", "vars",
+	    "textbook ms", "blocked ms", "threaded ms", num_threads);
+	for (uint32_t num_vars = 16u; num_vars <= 26u; num_vars += 2u) {
+		std::vector<double> values(std::size_t(1) << num_vars);
+		for (double& value : values) {
+			value = dist(rng);
+		}
+		std::vector<double> copy = values;
+		double const textbook = time_ms([&]() {
+			textbook_transform(copy);
+		});
+		copy = values;
+		double const blocked = time_ms([&]() {
+			walsh_hadamard_transform(copy, 1u);
+		});
+		copy = values;
+		double const threaded = time_ms([&]() {
+			walsh_hadamard_transform(copy, num_threads);
+		});
+		fmt::print("{:>6} {:>12.2f} {:>12.2f} {:>12.2f}\n", num_vars,
+		    textbook, blocked, threaded);
+	}
+	return 0;
+}
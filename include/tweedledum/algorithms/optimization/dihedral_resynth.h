@@ -0,0 +1,295 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../ir/Circuit.h"
+#include "../../ir/GateLib.h"
+#include "../../ir/Operator.h"
+#include "../../ir/Wire.h"
+#include "../../support/BitMatrix.h"
+#include "../../support/ThreadPool.h"
+#include "../simulation/circuit_to_phase_poly.h"
+#include "../synthesis/gray_synth.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// A CNOT-dihedral region is a part of a circuit made only of X, CNOT, Parity
+// and R1 gates.  Its action is fully described by its sum-over-paths form (see
+// `circuit_to_phase_poly`), from which `gray_synth` builds a new circuit that
+// often needs fewer CNOTs than the original gates.
+//
+// Regions are grown while walking the circuit.  Each qubit belongs to at most
+// one open region.  A dihedral gate joins the open regions of its qubits,
+// merging them if they differ, and a qubit without one starts a new region.
+// Any other gate closes the open regions of all the qubits of the regions it
+// touches.  Hence no gate outside a region ever lies between two of its gates,
+// and each region can be moved, as a whole, right before the gate closing it.
+//
+namespace tweedledum {
+#pragma region Implementation details
+namespace dihedral_resynth_detail {
+
+struct Region {
+	// Instructions of the region, in circuit order.
+	std::vector<uint32_t> instructions;
+	// Qubits (uids) of the region, sorted.  The i-th one becomes the qubit i
+	// of the region's circuit.
+	std::vector<uint32_t> qubits;
+	// Instruction before which the region is placed (or the end).
+	uint32_t position = 0u;
+};
+
+inline bool is_dihedral(Instruction const& inst)
+{
+	uint32_t const num_controls = std::distance(inst.begin(), inst.end()) - 1;
+	if (inst.is<GateLib::R1>()) {
+		return num_controls == 0u;
+	}
+	if (inst.is<GateLib::X>()) {
+		return num_controls <= 1u;
+	}
+	return inst.is<GateLib::Parity>();
+}
+
+// The cost of a dihedral circuit: its number of CNOTs, then its size.
+inline std::pair<uint32_t, uint32_t> cost(Circuit const& circuit)
+{
+	uint32_t num_cnots = 0u;
+	for (Instruction const& inst : circuit) {
+		if (!inst.is<GateLib::R1>()) {
+			num_cnots += std::distance(inst.begin(), inst.end()) - 1;
+		}
+	}
+	return {num_cnots, circuit.size()};
+}
+
+// Returns the regions sorted by position.
+inline std::vector<Region> find_regions(Circuit const& circuit)
+{
+	constexpr uint32_t no_region = std::numeric_limits<uint32_t>::max();
+	std::vector<Region> regions;
+	std::vector<uint32_t> open(circuit.num_wires(), no_region);
+	auto const close = [&](uint32_t id, uint32_t position) {
+		for (uint32_t qubit : regions[id].qubits) {
+			open[qubit] = no_region;
+		}
+		regions[id].position = position;
+	};
+
+	uint32_t position = 0u;
+	for (Instruction const& inst : circuit) {
+		if (!is_dihedral(inst)) {
+			for (WireRef wire : inst) {
+				if (open[wire.uid()] != no_region) {
+					close(open[wire.uid()], position);
+				}
+			}
+			++position;
+			continue;
+		}
+		// Join the largest of the open regions
+		uint32_t id = no_region;
+		for (WireRef wire : inst) {
+			uint32_t const other = open[wire.uid()];
+			if (other != no_region
+			    && (id == no_region
+			        || regions[other].instructions.size()
+			               > regions[id].instructions.size())) {
+				id = other;
+			}
+		}
+		if (id == no_region) {
+			id = regions.size();
+			regions.emplace_back();
+		}
+		Region& region = regions[id];
+		for (WireRef wire : inst) {
+			uint32_t const other = open[wire.uid()];
+			if (other == id) {
+				continue;
+			}
+			if (other == no_region) {
+				open[wire.uid()] = id;
+				region.qubits.push_back(wire.uid());
+				continue;
+			}
+			// Merge the other region into this one
+			Region& merged = regions[other];
+			for (uint32_t qubit : merged.qubits) {
+				open[qubit] = id;
+			}
+			region.qubits.insert(region.qubits.end(),
+			    merged.qubits.begin(), merged.qubits.end());
+			region.instructions.insert(region.instructions.end(),
+			    merged.instructions.begin(), merged.instructions.end());
+			merged.qubits.clear();
+			merged.instructions.clear();
+		}
+		region.instructions.push_back(position);
+		++position;
+	}
+	for (uint32_t id = 0u; id < regions.size(); ++id) {
+		if (!regions[id].qubits.empty() && open[regions[id].qubits[0]] == id) {
+			close(id, position);
+		}
+	}
+	// Drop the regions emptied by merges
+	regions.erase(std::remove_if(regions.begin(), regions.end(),
+	                  [](Region const& region) {
+		                  return region.instructions.empty();
+	                  }),
+	    regions.end());
+	for (Region& region : regions) {
+		std::sort(region.instructions.begin(), region.instructions.end());
+		std::sort(region.qubits.begin(), region.qubits.end());
+	}
+	std::stable_sort(regions.begin(), regions.end(),
+	    [](Region const& a, Region const& b) {
+		    return a.position < b.position;
+	    });
+	return regions;
+}
+
+// Returns the circuit of the region, or a cheaper one doing the same.
+inline Circuit resynthesize(
+    std::vector<Instruction const*> const& instructions, Region const& region)
+{
+	uint32_t const num_qubits = region.qubits.size();
+	Circuit original("region");
+	std::vector<WireRef> qubits;
+	qubits.reserve(num_qubits);
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		qubits.push_back(original.create_qubit());
+	}
+	std::vector<WireRef> wires;
+	for (uint32_t i : region.instructions) {
+		Instruction const& inst = *instructions[i];
+		wires.clear();
+		for (WireRef wire : inst) {
+			auto const it = std::lower_bound(
+			    region.qubits.begin(), region.qubits.end(), wire.uid());
+			WireRef const qubit = qubits[it - region.qubits.begin()];
+			wires.push_back(wire.is_complemented() ? !qubit : qubit);
+		}
+		original.create_instruction(
+		    static_cast<Operator const&>(inst), wires);
+	}
+	if (cost(original).first == 0u) {
+		return original;
+	}
+
+	std::optional<PhasePolynomial> const phase_poly
+	    = circuit_to_phase_poly(original);
+	assert(phase_poly);
+	BitMatrix linear_trans(num_qubits, num_qubits);
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		for (uint32_t j = 0u; j < num_qubits; ++j) {
+			linear_trans.set(i, j, phase_poly->linear_trans[i][j]);
+		}
+	}
+	Circuit candidate("region");
+	std::vector<WireRef> candidate_qubits;
+	candidate_qubits.reserve(num_qubits);
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		candidate_qubits.push_back(candidate.create_qubit());
+	}
+	gray_synth(
+	    candidate, candidate_qubits, linear_trans, phase_poly->terms);
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		if (phase_poly->complemented[i]) {
+			candidate.create_instruction(
+			    GateLib::X(), {candidate_qubits[i]});
+		}
+	}
+	if (cost(candidate) < cost(original)) {
+		return candidate;
+	}
+	return original;
+}
+
+} // namespace dihedral_resynth_detail
+#pragma endregion
+
+/*! \brief Resynthesis of the CNOT-dihedral regions of a circuit.
+ *
+ * Finds the maximal regions of the circuit made only of X, CNOT, Parity and R1
+ * gates, and resynthesizes each one from its phase polynomial and linear
+ * transformation using ``gray_synth``.  A region is replaced only when the new
+ * circuit has fewer CNOTs, or as many but fewer gates.  The result is equal to
+ * the original circuit up to a global phase.
+ *
+ * Regions are independent, so they are resynthesized in parallel.
+ *
+ * \param[in] original A circuit.
+ * \param[in] num_threads Number of threads (0 means one per hardware thread).
+ * \return A new circuit.
+ */
+inline Circuit dihedral_resynth(Circuit const& original,
+    uint32_t num_threads = 0u)
+{
+	using namespace dihedral_resynth_detail;
+	std::vector<Instruction const*> instructions;
+	instructions.reserve(original.size());
+	for (Instruction const& inst : original) {
+		instructions.push_back(&inst);
+	}
+	std::vector<Region> regions = find_regions(original);
+
+	std::vector<std::optional<Circuit>> replacements(regions.size());
+	ThreadPool pool(num_threads);
+	pool.parallel_for(regions.size(), [&](uint32_t id) {
+		replacements[id].emplace(resynthesize(instructions, regions[id]));
+	});
+
+	// Rebuild the circuit, placing each region right before the gate that
+	// closes it.
+	Circuit result(original.name());
+	std::vector<WireRef> qubits;
+	std::for_each(original.begin_wire(), original.end_wire(),
+	    [&](Wire const& wire) {
+		    qubits.push_back(result.create_qubit(wire.name));
+	    });
+	std::vector<bool> in_region(original.size(), false);
+	for (Region const& region : regions) {
+		for (uint32_t i : region.instructions) {
+			in_region[i] = true;
+		}
+	}
+	uint32_t next_region = 0u;
+	std::vector<WireRef> wires;
+	for (uint32_t i = 0u; i <= instructions.size(); ++i) {
+		for (; next_region < regions.size()
+		       && regions[next_region].position == i;
+		     ++next_region) {
+			Region const& region = regions[next_region];
+			for (Instruction const& inst : *replacements[next_region]) {
+				wires.clear();
+				for (WireRef wire : inst) {
+					WireRef const qubit = qubits[region.qubits[wire.uid()]];
+					wires.push_back(
+					    wire.is_complemented() ? !qubit : qubit);
+				}
+				result.create_instruction(
+				    static_cast<Operator const&>(inst), wires);
+			}
+		}
+		if (i == instructions.size() || in_region[i]) {
+			continue;
+		}
+		Instruction const& inst = *instructions[i];
+		result.create_instruction(static_cast<Operator const&>(inst),
+		    std::vector<WireRef>(inst.begin(), inst.end()));
+	}
+	return result;
+}
+
+} // namespace tweedledum
@@ -0,0 +1,171 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../ir/Circuit.h"
+#include "../../ir/GateLib.h"
+#include "../../ir/Operator.h"
+#include "../../ir/Wire.h"
+#include "../../support/DynamicBitset.h"
+#include "../../support/LinearPP.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Phase folding merges rotations that apply to the same parity.
+//
+// The pass simulates the circuit symbolically, like `circuit_to_phase_poly`,
+// keeping the parity each wire holds as a bit-packed vector, and whether the
+// wire is complemented.  X, CNOT and Parity gates update the parities, and
+// controlled rotations leave them alone as they are diagonal.  Any other gate
+// makes the values of its targets unknown, so each of them gets a fresh
+// variable.  Two uncontrolled R1 rotations on equal parities, wherever they
+// are, add up: the first one is kept with the sum of the angles, and the other
+// ones are removed.  (On a complemented wire, R1(a) is R1(-a) on the parity,
+// up to a global phase.)  Rotations whose angles sum up to 0 mod 2pi are
+// removed altogether.
+//
+// Each gate costs O(V/64) word operations, where V is the number of variables.
+//
+namespace tweedledum {
+#pragma region Implementation details
+namespace phase_folding_detail {
+
+inline uint32_t num_controls(Instruction const& inst)
+{
+	return std::distance(inst.begin(), inst.end()) - 1;
+}
+
+inline bool is_linear(Instruction const& inst)
+{
+	return (inst.is<GateLib::X>() && num_controls(inst) <= 1u)
+	       || inst.is<GateLib::Parity>();
+}
+
+inline bool is_diagonal(Instruction const& inst)
+{
+	return inst.is<GateLib::R1>();
+}
+
+// Wires whose value becomes unknown after `inst`.  A multiple-controlled X
+// only changes its target.
+inline auto fresh_wires(Instruction const& inst)
+{
+	return std::make_pair(
+	    inst.is<GateLib::X>() ? inst.end() - 1 : inst.begin(), inst.end());
+}
+
+} // namespace phase_folding_detail
+#pragma endregion
+
+/*! \brief Phase folding.
+ *
+ * Merges the uncontrolled R1 rotations that apply to the same parity of the
+ * circuit's inputs (or of the outputs of its non-linear gates), and removes
+ * those whose angles become 0 mod 2pi.  The result is equal to the original
+ * circuit up to a global phase.
+ *
+ * \param[in] original A circuit.
+ * \param[in] tolerance (optional) Angles within this distance of a multiple of
+ * 2pi count as zero.
+ * \return A new circuit.
+ */
+inline Circuit phase_folding(
+    Circuit const& original, double tolerance = 1e-12)
+{
+	using namespace phase_folding_detail;
+	using Parity = DynamicBitset<uint64_t>;
+
+	// Count the variables: one per wire, plus the fresh ones.
+	uint32_t num_vars = original.num_wires();
+	for (Instruction const& inst : original) {
+		if (!is_linear(inst) && !is_diagonal(inst)) {
+			auto const [begin, end] = fresh_wires(inst);
+			num_vars += std::distance(begin, end);
+		}
+	}
+	std::vector<Parity> parities;
+	parities.reserve(original.num_wires());
+	for (uint32_t i = 0u; i < original.num_wires(); ++i) {
+		parities.emplace_back(num_vars);
+		parities.back().set(i);
+	}
+	std::vector<bool> complemented(original.num_wires(), false);
+	uint32_t next_var = original.num_wires();
+
+	// Terms are never extracted, so the i-th one stays the parity of the i-th
+	// kept rotation, which is the first one on that parity.
+	constexpr uint32_t not_kept = std::numeric_limits<uint32_t>::max();
+	LinearPP<Parity> terms;
+	std::vector<bool> kept_negated;
+	std::vector<uint32_t> kept_term(original.size(), not_kept);
+	uint32_t position = 0u;
+	for (Instruction const& inst : original) {
+		uint32_t const target = inst.target().uid();
+		if (is_diagonal(inst)) {
+			if (num_controls(inst) == 0u) {
+				double const angle = inst.cast<GateLib::R1>().angle();
+				bool const negated = complemented[target];
+				uint32_t const num_terms = terms.size();
+				terms.add_term(parities[target], negated ? -angle : angle);
+				if (terms.size() != num_terms) {
+					kept_term[position] = num_terms;
+					kept_negated.push_back(negated);
+				}
+			}
+		} else if (is_linear(inst)) {
+			bool flip = inst.is<GateLib::X>() && num_controls(inst) == 0u;
+			std::for_each(inst.begin(), inst.end() - 1,
+			    [&](WireRef const& wire) {
+				    parities[target] ^= parities[wire.uid()];
+				    flip ^= complemented[wire.uid()] ^ wire.polarity();
+			    });
+			if (flip) {
+				complemented[target] = !complemented[target];
+			}
+		} else {
+			auto const [begin, end] = fresh_wires(inst);
+			std::for_each(begin, end, [&](WireRef const& wire) {
+				parities[wire.uid()].reset();
+				parities[wire.uid()].set(next_var++);
+				complemented[wire.uid()] = false;
+			});
+		}
+		++position;
+	}
+
+	Circuit result(original.name());
+	std::for_each(original.begin_wire(), original.end_wire(),
+	    [&](Wire const& wire) { result.create_qubit(wire.name); });
+	std::vector<double> angles;
+	angles.reserve(terms.size());
+	for (auto const& [parity, angle] : terms) {
+		angles.push_back(angle);
+	}
+	position = 0u;
+	for (Instruction const& inst : original) {
+		std::vector<WireRef> const wires(inst.begin(), inst.end());
+		if (!is_diagonal(inst) || num_controls(inst) != 0u) {
+			result.create_instruction(
+			    static_cast<Operator const&>(inst), wires);
+		} else if (kept_term[position] != not_kept) {
+			uint32_t const term = kept_term[position];
+			double const angle = angles[term];
+			if (std::abs(std::remainder(angle, 2 * M_PI)) > tolerance) {
+				result.create_instruction(GateLib::R1(
+				    kept_negated[term] ? -angle : angle), wires);
+			}
+		}
+		++position;
+	}
+	return result;
+}
+
+} // namespace tweedledum
@@ -0,0 +1,93 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../ir/Circuit.h"
+#include "../../ir/Wire.h"
+#include "../../support/ThreadPool.h"
+#include "simulate_classically.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace tweedledum {
+#pragma region Implementation details
+namespace circuit_to_permutation_detail {
+
+// Words in which bit `j` is the value of variable `i` in minterm `j`.  These
+// are the projections for the variables which vary within a 64-bit word.
+constexpr uint64_t projections[] = {0xaaaaaaaaaaaaaaaa, 0xcccccccccccccccc,
+    0xf0f0f0f0f0f0f0f0, 0xff00ff00ff00ff00, 0xffff0000ffff0000,
+    0xffffffff00000000};
+
+inline void simulate_words(Circuit const& circuit, uint64_t begin,
+    uint64_t end, std::vector<uint32_t>& permutation)
+{
+	uint32_t const num_qubits = circuit.num_qubits();
+	uint32_t const num_lanes = std::min<uint64_t>(permutation.size(), 64u);
+	std::vector<uint64_t> words(num_qubits);
+	for (uint64_t word = begin; word < end; ++word) {
+		for (uint32_t i = 0u; i < num_qubits; ++i) {
+			if (i < 6u) {
+				words[i] = projections[i];
+				continue;
+			}
+			words[i] = ((word >> (i - 6u)) & 1u) ? ~uint64_t(0) : 0u;
+		}
+		words = simulate_classically(circuit, std::move(words));
+		uint32_t* output = permutation.data() + (word << 6);
+		std::fill(output, output + num_lanes, 0u);
+		for (uint32_t i = 0u; i < num_qubits; ++i) {
+			uint64_t const value = words[i];
+			for (uint32_t lane = 0u; lane < num_lanes; ++lane) {
+				output[lane] |= ((value >> lane) & 1u) << i;
+			}
+		}
+	}
+}
+
+} // namespace circuit_to_permutation_detail
+#pragma endregion
+
+/*! \brief Computes the permutation realized by a reversible circuit.
+ *
+ * The :math:`2^n` input patterns are packed 64 per word and split into chunks
+ * which are simulated in parallel.  Each thread writes its chunk straight into
+ * the (preallocated) output vector.  The circuit must only contain classical
+ * reversible gates supported by ``simulate_classically``.
+ *
+ * __NOTE__: The output requires :math:`4 \cdot 2^n` bytes, e.g., 4 GiB for
+ * 30 qubits.
+ *
+ * \param[in] circuit A classical reversible circuit on at most 32 qubits.
+ * \param[in] num_threads Number of threads (0 means one per hardware thread).
+ * \return A vector of :math:`2^n` integers, the image of each input pattern.
+ */
+inline std::vector<uint32_t> circuit_to_permutation(
+    Circuit const& circuit, uint32_t num_threads = 0u)
+{
+	uint32_t const num_qubits = circuit.num_qubits();
+	assert(num_qubits <= 32u);
+	std::vector<uint32_t> permutation(uint64_t(1) << num_qubits);
+	uint64_t const num_words = ((permutation.size() - 1u) >> 6) + 1u;
+
+	ThreadPool pool(num_threads);
+	// Use a few chunks per thread so that the load is balanced, but keep
+	// them big enough for the per-chunk overhead to be negligible.
+	uint64_t const num_chunks
+	    = std::min<uint64_t>(num_words, pool.num_threads() * 4u);
+	uint64_t const chunk_size = (num_words + num_chunks - 1u) / num_chunks;
+	pool.parallel_for(num_chunks, [&](uint32_t chunk) {
+		uint64_t const begin = chunk * chunk_size;
+		uint64_t const end = std::min(begin + chunk_size, num_words);
+		circuit_to_permutation_detail::simulate_words(
+		    circuit, begin, end, permutation);
+	});
+	return permutation;
+}
+
+} // namespace tweedledum
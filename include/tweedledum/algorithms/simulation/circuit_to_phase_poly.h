@@ -0,0 +1,110 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../ir/Circuit.h"
+#include "../../ir/GateLib.h"
+#include "../../ir/Wire.h"
+#include "../../support/DynamicBitset.h"
+#include "../../support/LinearPP.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// A CNOT-dihedral circuit, i.e., one built using only {X, CNOT, Rz} gates, has
+// a canonical sum-over-paths form:
+//
+//     |x> --> exp(i * f(x)) |A x + b>
+//
+// where A is an invertible linear transformation over GF(2), b is a constant
+// bit-vector, and f is a phase polynomial: a sum of parities (linear
+// combinations of the input bits) weighted by angles, plus a global phase.
+//
+// The extraction simulates the circuit symbolically, keeping the parity each
+// qubit holds as a bit-packed vector.  A CNOT costs one XOR of two parities,
+// i.e., O(n/64) word operations, and a rotation adds one term to the phase
+// polynomial.  Parity gates (as generated by `xag_synth`) are also linear and
+// thus accepted.
+//
+namespace tweedledum {
+
+/*! \brief Sum-over-paths form of a CNOT-dihedral circuit. */
+struct PhasePolynomial {
+	using Parity = DynamicBitset<uint64_t>;
+
+	// Parities, over the inputs, and their angles (sorted by parity).
+	LinearPP<Parity> terms;
+	// Linear part of the output: parity held by each qubit at the end.
+	std::vector<Parity> linear_trans;
+	// Affine part of the output: which qubits end up complemented.
+	Parity complemented;
+	// Phase that does not depend on the input.
+	double global_phase = 0.0;
+};
+
+/*! \brief Computes the sum-over-paths form of a CNOT-dihedral circuit.
+ *
+ * \param[in] circuit A circuit with only X (with at most one control), Parity
+ * and single-qubit R1 gates.
+ * \return Its sum-over-paths form, or ``std::nullopt`` if the circuit has any
+ * other gate.
+ */
+inline std::optional<PhasePolynomial> circuit_to_phase_poly(
+    Circuit const& circuit)
+{
+	using Parity = PhasePolynomial::Parity;
+	uint32_t const num_qubits = circuit.num_qubits();
+
+	PhasePolynomial result;
+	result.complemented = Parity(num_qubits);
+	result.linear_trans.reserve(num_qubits);
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		result.linear_trans.emplace_back(num_qubits);
+		result.linear_trans.back().set(i);
+	}
+	auto& linear_trans = result.linear_trans;
+	auto& complemented = result.complemented;
+	for (Instruction const& inst : circuit) {
+		uint32_t const target = inst.target().uid();
+		uint32_t const num_controls
+		    = std::distance(inst.begin(), inst.end()) - 1;
+		if (inst.is<GateLib::R1>()) {
+			if (num_controls != 0u) {
+				return std::nullopt;
+			}
+			// A rotation on the parity `p + 1` is, up to a global
+			// phase, a rotation on `p` with the opposite angle.
+			double angle = inst.cast<GateLib::R1>().angle();
+			if (complemented[target]) {
+				result.global_phase += angle;
+				angle = -angle;
+			}
+			result.terms.add_term(linear_trans[target], angle);
+			continue;
+		}
+		bool const is_x = inst.is<GateLib::X>();
+		if (!is_x && !inst.is<GateLib::Parity>()) {
+			return std::nullopt;
+		}
+		if (is_x && num_controls > 1u) {
+			return std::nullopt;
+		}
+		bool flip = is_x && num_controls == 0u;
+		std::for_each(inst.begin(), inst.end() - 1,
+		[&](WireRef const& wire) {
+			linear_trans[target] ^= linear_trans[wire.uid()];
+			flip ^= complemented[wire.uid()] ^ wire.polarity();
+		});
+		if (flip) {
+			complemented.flip(target);
+		}
+	}
+	result.terms.finalize();
+	return result;
+}
+
+} // namespace tweedledum
@@ -0,0 +1,100 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../ir/Circuit.h"
+#include "../../ir/GateLib.h"
+#include "../../ir/Wire.h"
+
+#include <algorithm>
+#include <cassert>
+#include <kitty/kitty.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <vector>
+
+namespace tweedledum {
+#pragma region Implementation details
+namespace circuit_to_xag_detail {
+
+using Signal = mockturtle::xag_network::signal;
+
+// Builds the function of a truth table gate as a multiplexer tree over its
+// controls.  Structural hashing in the network takes care of constant leaves.
+inline Signal truth_table_signal(mockturtle::xag_network& network,
+    kitty::dynamic_truth_table const& tt, std::vector<Signal> const& controls)
+{
+	std::vector<Signal> level;
+	level.reserve(uint64_t(1) << controls.size());
+	for (uint64_t i = 0u; i < (uint64_t(1) << controls.size()); ++i) {
+		level.push_back(network.get_constant(kitty::get_bit(tt, i)));
+	}
+	for (Signal const& control : controls) {
+		for (uint64_t i = 0u; i < (level.size() >> 1); ++i) {
+			level[i] = network.create_ite(
+			    control, level[(i << 1) + 1], level[i << 1]);
+		}
+		level.resize(level.size() >> 1);
+	}
+	return level[0];
+}
+
+} // namespace circuit_to_xag_detail
+#pragma endregion
+
+/*! \brief Symbolically executes a classical circuit into an XAG.
+ *
+ * Every wire in ``inputs`` becomes a primary input, in that order, while all
+ * the other wires start in the constant 0 state (e.g., outputs and ancillae).
+ * The network will have one primary output for each wire in ``outputs``
+ * holding the wire's final state.  Supports the same gates as
+ * ``simulate_classically``: X (with any number of, possibly negative,
+ * controls), Parity and TruthTable gates.
+ *
+ * \param[in] circuit A classical reversible circuit.
+ * \param[in] inputs The wires that will become primary inputs.
+ * \param[in] outputs The wires that will become primary outputs.
+ * \return An XAG computing the ``outputs`` as functions of the ``inputs``.
+ */
+inline mockturtle::xag_network circuit_to_xag(Circuit const& circuit,
+    std::vector<WireRef> const& inputs, std::vector<WireRef> const& outputs)
+{
+	using Signal = circuit_to_xag_detail::Signal;
+
+	mockturtle::xag_network network;
+	std::vector<Signal> to_signal(
+	    circuit.num_wires(), network.get_constant(false));
+	for (WireRef const& wire : inputs) {
+		to_signal.at(wire.uid()) = network.create_pi();
+	}
+	for (Instruction const& inst : circuit) {
+		std::vector<Signal> controls;
+		std::for_each(inst.begin(), inst.end() - 1,
+		[&](WireRef const& wire) {
+			controls.push_back(
+			    to_signal[wire.uid()] ^ (wire.polarity() != 0));
+		});
+		Signal& target = to_signal[inst.target().uid()];
+		if (inst.is<GateLib::X>()) {
+			target = network.create_xor(
+			    target, network.create_nary_and(controls));
+		} else if (inst.is<GateLib::Parity>()) {
+			target = network.create_xor(
+			    target, network.create_nary_xor(controls));
+		} else if (inst.is<GateLib::TruthTable>()) {
+			auto const& tt = inst.cast<GateLib::TruthTable>();
+			target = network.create_xor(target,
+			    circuit_to_xag_detail::truth_table_signal(
+			        network, tt.truth_table(), controls));
+		} else {
+			assert(0 && "The circuit must be classical");
+		}
+	}
+	for (WireRef const& wire : outputs) {
+		network.create_po(to_signal.at(wire.uid()));
+	}
+	return network;
+}
+
+} // namespace tweedledum
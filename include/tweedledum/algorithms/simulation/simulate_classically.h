@@ -14,7 +14,63 @@
 #include <vector>
 
 namespace tweedledum {
+#pragma region Implementation details
+namespace simulate_classically_detail {
 
+inline uint64_t polarity_mask(WireRef const& wire)
+{
+	return wire.polarity() ? ~uint64_t(0) : uint64_t(0);
+}
+
+// Parity gate: the target is XORed with all the other wires.
+inline uint64_t parity_word(
+    Instruction const& inst, std::vector<uint64_t> const& patterns)
+{
+	uint64_t result = 0u;
+	std::for_each(inst.begin(), inst.end() - 1, [&](WireRef const& wire) {
+		result ^= patterns[wire.uid()] ^ polarity_mask(wire);
+	});
+	return result;
+}
+
+// Evaluates the truth table on 64 patterns at once.  The leaves of a
+// multiplexer tree are the (constant) truth table bits, each level selects
+// between pairs of cofactors using the word of one control.  This costs
+// 2^k - 1 word operations for a k-controls gate, no matter the word width.
+inline uint64_t truth_table_word(Instruction const& inst,
+    kitty::dynamic_truth_table const& tt, std::vector<uint64_t> const& patterns,
+    std::vector<uint64_t>& scratch)
+{
+	uint32_t const num_controls = std::distance(inst.begin(), inst.end()) - 1;
+	assert(num_controls <= tt.num_vars());
+	scratch.resize(uint64_t(1) << num_controls);
+	for (uint64_t i = 0u; i < scratch.size(); ++i) {
+		scratch[i] = kitty::get_bit(tt, i) ? ~uint64_t(0) : uint64_t(0);
+	}
+	uint64_t size = scratch.size();
+	std::for_each(inst.begin(), inst.end() - 1, [&](WireRef const& wire) {
+		uint64_t const control = patterns[wire.uid()] ^ polarity_mask(wire);
+		size >>= 1;
+		for (uint64_t i = 0u; i < size; ++i) {
+			scratch[i] = (control & scratch[(i << 1) + 1])
+			             | (~control & scratch[i << 1]);
+		}
+	});
+	return scratch[0];
+}
+
+} // namespace simulate_classically_detail
+#pragma endregion
+
+/*! \brief Classical simulation.
+ *
+ * Supports X (with any number of, possibly negative, controls), Parity and
+ * TruthTable gates.
+ *
+ * \param[in] circuit A classical reversible circuit.
+ * \param[in] pattern The input values, one bit per qubit.
+ * \return The output values, one bit per qubit.
+ */
 template<typename WordType>
 inline DynamicBitset<WordType> simulate_classically(
     Circuit const& circuit, DynamicBitset<WordType> pattern)
@@ -24,15 +80,22 @@ inline DynamicBitset<WordType> simulate_classically(
 		bool execute = true;
 		if (inst.is<GateLib::TruthTable>()) {
 			auto const& tt = inst.cast<GateLib::TruthTable>();
-			// TODO: refactor:
 			uint32_t i = 0;
 			uint32_t pos = 0u;
 			std::for_each(inst.begin(), inst.end() - 1,
 			[&](WireRef const& wire) {
-				pos |= (pattern[wire.uid()] << i);
+				bool const bit = pattern[wire.uid()];
+				pos |= ((bit ^ wire.polarity()) << i);
 				++i;
 			});
 			execute &= kitty::get_bit(tt.truth_table(), pos);
+		} else if (inst.is<GateLib::Parity>()) {
+			execute = false;
+			std::for_each(inst.begin(), inst.end() - 1,
+			[&](WireRef const& wire) {
+				bool const bit = pattern[wire.uid()];
+				execute ^= bit ^ wire.polarity();
+			});
 		} else if (inst.is<GateLib::X>()) {
 			std::for_each(inst.begin(), inst.end() - 1,
 			[&](WireRef const& wire) {
@@ -47,4 +110,40 @@ inline DynamicBitset<WordType> simulate_classically(
 	return pattern;
 }
 
-} // namespace tweedledum
\ No newline at end of file
+/*! \brief Bit-parallel classical simulation.
+ *
+ * Simulates 64 input patterns at once.  Each word of ``patterns`` holds the
+ * values of one qubit, i.e., bit ``j`` of ``patterns[i]`` is the value of the
+ * qubit ``i`` in the ``j``-th pattern.  Supports the same gates as the
+ * single-pattern simulation, all of them evaluated with word operations.
+ *
+ * \param[in] circuit A classical reversible circuit.
+ * \param[in] patterns One word per qubit.
+ * \return The simulated words, one per qubit.
+ */
+inline std::vector<uint64_t> simulate_classically(
+    Circuit const& circuit, std::vector<uint64_t> patterns)
+{
+	using namespace simulate_classically_detail;
+	assert(circuit.num_qubits() == patterns.size());
+	std::vector<uint64_t> scratch;
+	for (auto const& inst : circuit) {
+		uint64_t execute = ~uint64_t(0);
+		if (inst.is<GateLib::TruthTable>()) {
+			auto const& tt = inst.cast<GateLib::TruthTable>();
+			execute = truth_table_word(
+			    inst, tt.truth_table(), patterns, scratch);
+		} else if (inst.is<GateLib::Parity>()) {
+			execute = parity_word(inst, patterns);
+		} else if (inst.is<GateLib::X>()) {
+			std::for_each(inst.begin(), inst.end() - 1,
+			[&](WireRef const& wire) {
+				execute &= patterns[wire.uid()] ^ polarity_mask(wire);
+			});
+		}
+		patterns[inst.target().uid()] ^= execute;
+	}
+	return patterns;
+}
+
+} // namespace tweedledum
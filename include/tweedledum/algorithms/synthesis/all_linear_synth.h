@@ -10,6 +10,13 @@
 #include "../../support/LinearPP.h"
 #include "../../support/Matrix.h"
 
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 // A CNOT-dihedral circuit is just a fancy way of way the circuit is built using
 // only {X, CNOT, Rz} gates.  We know that every circuit written over this gate
 // set has a canonical sum-over-paths form.
@@ -55,54 +62,65 @@ namespace all_linear_synth_detail {
 
 // I added this level of indirection because I can implement this method with
 // other codes or just using binary sequence.
-template<typename Parity>
-void synthesize(Circuit& circuit, std::vector<WireRef> const& qubits,
-    LinearPP<Parity> parities)
+//
+// The Gray code is generated on the fly: between codes `j - 1` and `j` the bit
+// that flips is the lowest set bit of `j`.  In the round of qubit `i`, the
+// state of the qubit goes through `x_i` plus every non-empty combination of
+// the lower variables, and then back to `x_i`.  Thus, every non-zero parity
+// shows up exactly once (besides these returns).
+//
+// Qubit states are kept as 64-bit masks, and angles are looked up in a dense
+// table indexed by mask.  The table has 2^num_qubits entries, as many as the
+// circuit has phase gates; besides it, the memory used is O(num_qubits).
+template<typename Parity, typename CnotFn, typename PhaseFn>
+void synthesize(uint32_t num_qubits, LinearPP<Parity> const& parities,
+    CnotFn&& on_cnot, PhaseFn&& on_phase)
 {
-	// Generate Gray code
-	std::vector<uint32_t> gray_code(1u << circuit.num_qubits());
-	for (uint32_t i = 0; i < (1u << circuit.num_qubits()); ++i) {
-		gray_code.at(i) = ((i >> 1) ^ i);
+	assert(num_qubits < 64u);
+	if constexpr (std::is_integral_v<Parity>) {
+		assert(num_qubits <= std::numeric_limits<Parity>::digits);
+	}
+	// Without qubits, every term is constant, i.e., a global phase.
+	if (num_qubits == 0u) {
+		return;
+	}
+	std::vector<double> angles(uint64_t(1) << num_qubits, 0.0);
+	for (auto const& [parity, angle] : parities) {
+		uint64_t mask = 0u;
+		for (uint32_t i = 0u; i < num_qubits; ++i) {
+			mask |= uint64_t(parity_has_var(parity, i)) << i;
+		}
+		angles[mask] += angle;
 	}
 
 	// Initialize the parity of each qubit state
 	// Applying phase gate to parities that consisting of just one variable
 	// i is the index of the target
-	std::vector<uint32_t> qubits_states(circuit.num_qubits(), 0);
-	for (uint32_t i = 0u; i < circuit.num_qubits(); ++i) {
-		qubits_states[i] = (1u << i);
-		auto angle = parities.extract_term(qubits_states[i]);
+	std::vector<uint64_t> qubits_states(num_qubits);
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		qubits_states[i] = uint64_t(1) << i;
+		double const angle = angles[qubits_states[i]];
 		if (angle != 0.0) {
-			circuit.create_instruction(
-			    GateLib::R1(angle), {qubits[i]});
+			on_phase(i, angle);
 		}
 	}
 
-	for (uint32_t i = circuit.num_qubits() - 1; i > 0; --i) {
-		for (uint32_t j = (1u << (i + 1)) - 1; j > (1u << i); --j) {
-			uint32_t c0
-			    = std::log2(gray_code[j] ^ gray_code[j - 1u]);
-			circuit.create_instruction(
-			    GateLib::X(), {qubits[c0]}, qubits[i]);
-
+	for (uint32_t i = num_qubits - 1; i > 0; --i) {
+		uint64_t const end = uint64_t(1) << i;
+		for (uint64_t j = (end << 1) - 1u; j > end; --j) {
+			uint32_t const c0 = __builtin_ctzll(j);
+			on_cnot(c0, i);
 			qubits_states[i] ^= qubits_states[c0];
-			auto angle = parities.extract_term(qubits_states[i]);
+			double const angle = angles[qubits_states[i]];
 			if (angle != 0.0) {
-				circuit.create_instruction(
-				    GateLib::R1(angle), {qubits[i]});
+				on_phase(i, angle);
 			}
 		}
-		uint32_t c1 = std::log2(
-		    gray_code[1 << i] ^ gray_code[(1u << (i + 1)) - 1u]);
-		circuit.create_instruction(
-		    GateLib::X(), {qubits[c1]}, qubits[i]);
-
+		// Codes 2^i and 2^(i + 1) - 1 differ in bit i - 1.  This brings
+		// the qubit back to x_i, whose phase is already applied.
+		uint32_t const c1 = i - 1u;
+		on_cnot(c1, i);
 		qubits_states[i] ^= qubits_states[c1];
-		auto angle = parities.extract_term(qubits_states[i]);
-		if (angle != 0.0) {
-			circuit.create_instruction(
-			    GateLib::R1(angle), {qubits[i]});
-		}
 	}
 }
 
@@ -127,7 +145,42 @@ inline void all_linear_synth(Circuit& circuit,
 	if (parities.size() == 0) {
 		return;
 	}
-	all_linear_synth_detail::synthesize(circuit, qubits, parities);
+	all_linear_synth_detail::synthesize(
+	    qubits.size(), parities,
+	    [&](uint32_t control, uint32_t target) {
+		    circuit.create_instruction(
+		        GateLib::X(), {qubits[control]}, qubits[target]);
+	    },
+	    [&](uint32_t qubit, double angle) {
+		    circuit.create_instruction(
+		        GateLib::R1(angle), {qubits[qubit]});
+	    });
+}
+
+/*! \brief Streaming synthesis of a CNOT-dihedral circuits with all linear
+ * combinations.
+ *
+ * Instead of building a circuit, each gate is passed, in circuit order, to one
+ * of the callbacks: ``on_cnot(control, target)`` or ``on_phase(qubit, angle)``.
+ * Qubits are given by their indices in ``[0, num_qubits)``.  Besides the input,
+ * this only takes a table of 2^num_qubits angles, 8 bytes per parity, and
+ * O(num_qubits) memory, which makes it usable to count, write out, or map gates
+ * of circuits too large to be held in memory.
+ *
+ * \param[in] num_qubits The number of qubits.
+ * \param[in] parities List of parities and their associated angles.
+ * \param[in] on_cnot Called for every CNOT gate.
+ * \param[in] on_phase Called for every phase (R1) gate.
+ */
+template<typename Parity, typename CnotFn, typename PhaseFn>
+inline void all_linear_synth(uint32_t num_qubits,
+    LinearPP<Parity> const& parities, CnotFn&& on_cnot, PhaseFn&& on_phase)
+{
+	if (parities.size() == 0) {
+		return;
+	}
+	all_linear_synth_detail::synthesize(num_qubits, parities,
+	    std::forward<CnotFn>(on_cnot), std::forward<PhaseFn>(on_phase));
 }
 
 /*! \brief Synthesis of a CNOT-dihedral circuits with all linear combinations.
@@ -7,7 +7,18 @@
 #include "../../ir/Circuit.h"
 #include "../../ir/GateLib.h"
 #include "../../ir/Wire.h"
+#include "../../support/BitMatrix.h"
 #include "../../support/Matrix.h"
+#include "../../support/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
 
 // This implementation is based on:
 //
@@ -42,92 +53,176 @@ namespace cnot_synth_detail {
 using AbstractGate = std::pair<uint32_t, uint32_t>;
 using GateList = std::vector<AbstractGate>;
 
-template<typename T>
-inline void pattern_elimination(
-    Matrix<T>& matrix, uint32_t start, uint32_t end, GateList& gates)
+// Gets the bits of `row` in the columns [start, end) as an integer.
+inline uint32_t row_pattern(
+    BitMatrix const& matrix, uint32_t row, uint32_t start, uint32_t end)
+{
+	assert(end - start < 32u);
+	BitMatrix::word_type const* data = matrix.row_data(row);
+	uint32_t const word = start / BitMatrix::word_width;
+	uint32_t const offset = start % BitMatrix::word_width;
+	uint64_t bits = data[word] >> offset;
+	if (offset + (end - start) > BitMatrix::word_width) {
+		bits |= data[word + 1] << (BitMatrix::word_width - offset);
+	}
+	return bits & ((uint64_t(1) << (end - start)) - 1u);
+}
+
+// The table maps each pattern to the first row, from `start`, having it.  Any
+// later row with the same pattern can be cleared of it with a single CNOT.
+inline void pattern_elimination(BitMatrix& matrix, uint32_t start,
+    uint32_t end, std::vector<uint32_t>& table, GateList& gates)
 {
-	std::vector<uint32_t> table(matrix.num_rows(), 0);
-	auto const begin = table.begin() + start;
+	uint32_t const no_row = matrix.num_rows();
+	std::fill(table.begin(), table.begin() + (1u << (end - start)), no_row);
 	for (uint32_t row = start; row < matrix.num_rows(); ++row) {
-		uint32_t pattern = 0u;
-		uint32_t subrow_col = 0u;
-		for (uint32_t col = start; col < end; ++col) {
-			pattern |= (matrix(row, col) << subrow_col);
-			subrow_col += 1;
-		}
+		uint32_t const pattern = row_pattern(matrix, row, start, end);
 		if (pattern == 0) {
 			continue;
 		}
-		auto const it = std::find(begin, table.end(), pattern);
-		if (it != table.end()) {
-			uint32_t pos = std::distance(table.begin(), it);
-			matrix.row(row) ^= std::valarray(matrix.row(pos));
+		uint32_t const pos = table[pattern];
+		if (pos != no_row) {
+			matrix.row_xor(row, pos);
 			gates.emplace_back(pos, row);
 		} else {
-			table[row] = pattern;
+			table[pattern] = row;
 		}
 	}
 }
 
-template<typename T>
 inline void gaussian_elimination(
-    Matrix<T>& matrix, uint32_t start, uint32_t end, GateList& gates)
+    BitMatrix& matrix, uint32_t start, uint32_t end, GateList& gates)
 {
 	for (uint32_t col = start; col < end; ++col) {
-		bool is_diagonal_one = (matrix(col, col) == 1);
+		bool is_diagonal_one = matrix(col, col);
 		for (uint32_t row = col + 1; row < matrix.num_rows(); ++row) {
-			if (matrix(row, col) == 0) {
+			if (!matrix(row, col)) {
 				continue;
 			}
 			if (!is_diagonal_one) {
 				is_diagonal_one = 1;
-				matrix.row(col)
-				    ^= std::valarray(matrix.row(row));
+				matrix.row_xor(col, row);
 				gates.emplace_back(row, col);
 			}
-			matrix.row(row) ^= std::valarray(matrix.row(col));
+			matrix.row_xor(row, col);
 			gates.emplace_back(col, row);
 		}
 	}
 }
 
-template<typename T>
-inline GateList lower_cnot_synthesis(Matrix<T>& matrix, uint32_t section_size)
+inline GateList lower_cnot_synthesis(BitMatrix& matrix, uint32_t section_size)
 {
 	GateList gates;
 	uint32_t const num_cols = matrix.num_columns();
 	uint32_t const num_sections = (num_cols - 1u) / section_size + 1u;
+	std::vector<uint32_t> table(1u << section_size);
 	for (uint32_t section = 0u; section < num_sections; ++section) {
 		uint32_t start = section * section_size;
 		uint32_t end = std::min(start + section_size, num_cols);
-		pattern_elimination(matrix, start, end, gates);
+		pattern_elimination(matrix, start, end, table, gates);
 		gaussian_elimination(matrix, start, end, gates);
 	}
 	return gates;
 }
 
-template<typename T>
-void synthesize(
-    Circuit& circuit, std::vector<WireRef> const& qubits, Matrix<T> matrix)
+// The analysis of Patel et al. asks for sections of about log2(n) / 2 columns,
+// which makes the number of distinct patterns grow like sqrt(n).
+inline uint32_t default_section_size(uint32_t num_qubits)
 {
-	// FIXME: for now the section_size is hardcoded to be '2'
-	GateList lower = lower_cnot_synthesis(matrix, 2u);
-	// TODO: Implement a transpose inpace
-	auto transposed = transpose(matrix);
-	GateList upper = lower_cnot_synthesis(transposed, 2u);
+	if (num_qubits < 2u) {
+		return 1u;
+	}
+	uint32_t const size = std::lround(std::log2(num_qubits) / 2.0);
+	return std::clamp(size, 1u, 16u);
+}
 
+// Returns the gates, in circuit order, of a circuit implementing `matrix`.
+inline GateList synthesize(BitMatrix matrix, uint32_t section_size)
+{
+	if (section_size == 0u) {
+		section_size = default_section_size(matrix.num_rows());
+	}
+	assert(section_size < 32u);
+	GateList lower = lower_cnot_synthesis(matrix, section_size);
+	transpose_inplace(matrix);
+	GateList upper = lower_cnot_synthesis(matrix, section_size);
+
+	GateList gates;
+	gates.reserve(upper.size() + lower.size());
 	for (auto const& [control, target] : upper) {
 		// switch control/target of CX gates in gates_upper;
-		circuit.create_instruction(
-		    GateLib::X(), {qubits[target]}, qubits[control]);
+		gates.emplace_back(target, control);
 	}
-	std::reverse(lower.begin(), lower.end());
-	for (auto const& [control, target] : lower) {
+	gates.insert(gates.end(), lower.rbegin(), lower.rend());
+	return gates;
+}
+
+inline void add_gates(Circuit& circuit, std::vector<WireRef> const& qubits,
+    GateList const& gates)
+{
+	for (auto const& [control, target] : gates) {
 		circuit.create_instruction(
 		    GateLib::X(), {qubits[control]}, qubits[target]);
 	}
 }
 
+// One run of the portfolio.  A non-zero `row_order` seeds a random relabeling
+// of the qubits, i.e., the matrix is conjugated by a permutation.
+struct Config {
+	uint32_t section_size;
+	bool transposed;
+	uint32_t row_order;
+};
+
+// Returns `matrix` with both its rows and its columns permuted:
+// result(i, j) = matrix(perm[i], perm[j]).
+inline BitMatrix permute(BitMatrix const& matrix,
+    std::vector<uint32_t> const& perm)
+{
+	uint32_t const num_words = matrix.row_words();
+	auto permute_rows = [&](BitMatrix const& from) {
+		BitMatrix to(from.num_rows(), from.num_columns());
+		for (uint32_t i = 0u; i < from.num_rows(); ++i) {
+			std::copy_n(from.row_data(perm[i]), num_words,
+			    to.row_data(i));
+		}
+		return to;
+	};
+	BitMatrix result = transpose(permute_rows(matrix));
+	result = permute_rows(result);
+	transpose_inplace(result);
+	return result;
+}
+
+inline GateList synthesize(BitMatrix const& matrix, Config const& config)
+{
+	std::vector<uint32_t> perm(matrix.num_rows());
+	std::iota(perm.begin(), perm.end(), 0u);
+	if (config.row_order != 0u) {
+		std::mt19937 gen(config.row_order);
+		std::shuffle(perm.begin(), perm.end(), gen);
+	}
+	BitMatrix permuted
+	    = config.row_order != 0u ? permute(matrix, perm) : matrix;
+	// A circuit for the transposed matrix, reversed and with controls and
+	// targets swapped, implements the original one.
+	if (config.transposed) {
+		transpose_inplace(permuted);
+	}
+	GateList gates = synthesize(std::move(permuted), config.section_size);
+	if (config.transposed) {
+		std::reverse(gates.begin(), gates.end());
+		for (auto& [control, target] : gates) {
+			std::swap(control, target);
+		}
+	}
+	for (auto& [control, target] : gates) {
+		control = perm[control];
+		target = perm[target];
+	}
+	return gates;
+}
+
 } // namespace cnot_synth_detail
 #pragma endregion
 
@@ -142,21 +237,169 @@ void synthesize(
  * synthesized on.
  * \param[in] qubits The wires that will be used.
  * \param[in] matrix An N x N binary matrix.
+ * \param[in] section_size (optional) Number of columns eliminated together
+ * using a lookup table of the row patterns.  The default, 0, picks about
+ * log2(N) / 2.
  */
+inline void cnot_synth(Circuit& circuit, std::vector<WireRef> const& qubits,
+    BitMatrix const& matrix, uint32_t section_size = 0u)
+{
+	assert(matrix.num_rows() == matrix.num_columns());
+	assert(matrix.num_rows() == qubits.size());
+	cnot_synth_detail::add_gates(circuit, qubits,
+	    cnot_synth_detail::synthesize(matrix, section_size));
+}
+
 template<typename T>
 inline void cnot_synth(Circuit& circuit, std::vector<WireRef> const& qubits,
-    Matrix<T> const& matrix)
+    Matrix<T> const& matrix, uint32_t section_size = 0u)
 {
-	cnot_synth_detail::synthesize(circuit, qubits, matrix);
+	cnot_synth(circuit, qubits, BitMatrix(matrix), section_size);
 }
 
 /*! \brief Synthesis of linear reversible circuits (CNOT synthesis).
  *
  * \param[in] matrix An N x N binary matrix.
+ * \param[in] section_size (optional) Number of columns eliminated together,
+ * 0 means automatic.
  * \return A linear reversible circuit on N wires.
  */
+inline Circuit cnot_synth(BitMatrix const& matrix, uint32_t section_size = 0u)
+{
+	assert(matrix.num_rows() == matrix.num_columns());
+	// TODO: method to generate a name;
+	Circuit circuit("my_circuit");
+
+	// Create the necessary qubits
+	uint32_t const num_qubits = matrix.num_rows();
+	std::vector<WireRef> wires;
+	wires.reserve(num_qubits);
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		wires.emplace_back(circuit.create_qubit());
+	}
+	cnot_synth(circuit, wires, matrix, section_size);
+	return circuit;
+}
+
 template<typename T>
-inline Circuit cnot_synth(Matrix<T> const& matrix)
+inline Circuit cnot_synth(Matrix<T> const& matrix, uint32_t section_size = 0u)
+{
+	return cnot_synth(BitMatrix(matrix), section_size);
+}
+
+/*! \brief Batch synthesis of linear reversible circuits.
+ *
+ * Meant for callers that need many small linear transformations at once, e.g.,
+ * one per CNOT-phase region of a larger circuit.  No circuit is built: each
+ * result is just a list of ``(control, target)`` pairs, in circuit order, over
+ * the qubits ``0 .. N-1`` of the corresponding matrix, which the caller maps
+ * to its own qubits.  Matrices are synthesized in parallel.
+ *
+ * \param[in] matrices A list of square binary matrices (of any size).
+ * \param[in] section_size (optional) Number of columns eliminated together,
+ * 0 means automatic (for each matrix).
+ * \param[in] num_threads Number of threads (0 means one per hardware thread).
+ * \return One list of CNOT gates per matrix.
+ */
+inline std::vector<std::vector<std::pair<uint32_t, uint32_t>>>
+cnot_synth_batch(std::vector<BitMatrix> const& matrices,
+    uint32_t section_size = 0u, uint32_t num_threads = 0u)
+{
+	std::vector<cnot_synth_detail::GateList> results(matrices.size());
+	if (matrices.empty()) {
+		return results;
+	}
+	ThreadPool pool(std::min<uint32_t>(
+	    num_threads ? num_threads : std::thread::hardware_concurrency(),
+	    matrices.size()));
+	pool.parallel_for(matrices.size(), [&](uint32_t i) {
+		assert(matrices[i].num_rows() == matrices[i].num_columns());
+		results[i]
+		    = cnot_synth_detail::synthesize(matrices[i], section_size);
+	});
+	return results;
+}
+
+/*! \brief Portfolio CNOT synthesis.
+ *
+ * The number of gates generated by ``cnot_synth`` depends strongly on the
+ * section size and on the order of the rows and columns of the matrix.  This
+ * variant synthesizes several configurations concurrently and keeps the one
+ * with fewest CNOTs.  The configurations combine section sizes around the
+ * default one, the original and the transposed matrix, and ``num_row_orders``
+ * random relabelings of the qubits.
+ *
+ * The configuration used by ``cnot_synth`` always runs, so the result is never
+ * worse.  All the other ones are deterministic, so is the result unless the
+ * time budget runs out.
+ *
+ * \param[inout] circuit A circuit in which the linear transformation will be
+ * synthesized on.
+ * \param[in] qubits The wires that will be used.
+ * \param[in] matrix An N x N binary matrix.
+ * \param[in] num_row_orders Number of random relabelings to try.
+ * \param[in] num_threads Number of threads (0 means one per hardware thread).
+ * \param[in] time_budget (optional) Configurations that did not start within
+ * this time are skipped, 0 means no limit.
+ */
+inline void cnot_synth_portfolio(Circuit& circuit,
+    std::vector<WireRef> const& qubits, BitMatrix const& matrix,
+    uint32_t num_row_orders = 4u, uint32_t num_threads = 0u,
+    std::chrono::milliseconds time_budget = std::chrono::milliseconds(0))
+{
+	using namespace cnot_synth_detail;
+	using Clock = std::chrono::steady_clock;
+	assert(matrix.num_rows() == matrix.num_columns());
+	assert(matrix.num_rows() == qubits.size());
+
+	uint32_t const default_size = default_section_size(matrix.num_rows());
+	uint32_t const min_size = default_size > 2u ? default_size - 2u : 1u;
+	uint32_t const max_size = std::min(default_size + 2u, 16u);
+	std::vector<Config> configs(1, {default_size, false, 0u});
+	for (uint32_t order = 0u; order <= num_row_orders; ++order) {
+		for (bool transposed : {false, true}) {
+			for (uint32_t size = min_size; size <= max_size; ++size) {
+				if (size == default_size && !transposed
+				    && order == 0u) {
+					continue;
+				}
+				configs.push_back({size, transposed, order});
+			}
+		}
+	}
+
+	auto const start = Clock::now();
+	std::vector<GateList> results(configs.size());
+	ThreadPool pool(num_threads);
+	pool.parallel_for(configs.size(), [&](uint32_t i) {
+		if (i != 0u && time_budget.count() > 0
+		    && Clock::now() - start > time_budget) {
+			return;
+		}
+		results[i] = synthesize(matrix, configs[i]);
+	});
+
+	// Skipped configurations have empty results, but so has the identity.
+	GateList const* best = &results[0];
+	for (GateList const& gates : results) {
+		if (!gates.empty() && gates.size() < best->size()) {
+			best = &gates;
+		}
+	}
+	add_gates(circuit, qubits, *best);
+}
+
+/*! \brief Portfolio CNOT synthesis.
+ *
+ * \param[in] matrix An N x N binary matrix.
+ * \param[in] num_row_orders Number of random relabelings to try.
+ * \param[in] num_threads Number of threads (0 means one per hardware thread).
+ * \param[in] time_budget (optional) 0 means no limit.
+ * \return A linear reversible circuit on N wires.
+ */
+inline Circuit cnot_synth_portfolio(BitMatrix const& matrix,
+    uint32_t num_row_orders = 4u, uint32_t num_threads = 0u,
+    std::chrono::milliseconds time_budget = std::chrono::milliseconds(0))
 {
 	assert(matrix.num_rows() == matrix.num_columns());
 	// TODO: method to generate a name;
@@ -169,7 +412,8 @@ inline Circuit cnot_synth(Matrix<T> const& matrix)
 	for (uint32_t i = 0u; i < num_qubits; ++i) {
 		wires.emplace_back(circuit.create_qubit());
 	}
-	cnot_synth(circuit, wires, matrix);
+	cnot_synth_portfolio(
+	    circuit, wires, matrix, num_row_orders, num_threads, time_budget);
 	return circuit;
 }
 
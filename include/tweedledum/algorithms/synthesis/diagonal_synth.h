@@ -7,70 +7,62 @@
 #include "../../ir/Circuit.h"
 #include "../../ir/GateLib.h"
 #include "../../ir/Wire.h"
+#include "../../support/BitMatrix.h"
 #include "../../support/LinearPP.h"
+#include "../../support/WalshHadamard.h"
 #include "all_linear_synth.h"
 #include "gray_synth.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
 namespace tweedledum {
 #pragma region Implementation details
 namespace diagonal_synth_detail {
 
-inline void complement_qubit(uint32_t i, std::vector<double>& angles)
-{
-	uint32_t const size_2 = (angles.size() / 2);
-	uint32_t const step = (size_2 >> i);
-	for (uint32_t j = 0u; j < size_2; j += step) {
-		for (uint32_t k = (j << 1); k < (step + (j << 1)); k += 1) {
-			std::swap(angles.at(k), angles.at(step + k));
-		}
-	}
-}
-
+// Returns the angles negated and indexed by the uncomplemented qubits, which
+// replace the complemented ones in `qubits`.
 inline std::vector<double> fix_angles(
     std::vector<WireRef>& qubits, std::vector<double> const& angles)
 {
-	std::vector<double> new_angles;
-	std::transform(angles.begin(), angles.end(),
-	    std::back_inserter(new_angles), [](double a) {
-		    return -a;
-	    });
-
 	// Normalize qubits polarity
-	uint32_t index = 0u;
-	for (uint32_t i = qubits.size(); i-- > 0;) {
-		if (!qubits.at(index).is_complemented()) {
-			index += 1;
+	uint64_t mask = 0u;
+	for (uint32_t i = 0u; i < qubits.size(); ++i) {
+		if (!qubits[i].is_complemented()) {
 			continue;
 		}
-		qubits.at(index).complement();
-		complement_qubit(index, new_angles);
-		index += 1;
+		qubits[i].complement();
+		mask |= (uint64_t(1) << i);
 	}
+	std::vector<double> new_angles(angles.size());
+	xor_permute(angles.data(), new_angles.data(), angles.size(), mask,
+	    /* negate */ true);
 	return new_angles;
 }
 
-inline void fast_hadamard_transform(std::vector<double>& angles)
-{
-	uint32_t k = 0u;
-	for (uint32_t m = 1u; m < angles.size(); m <<= 1u) {
-		for (uint32_t i = 0u; i < angles.size(); i += (m << 1u)) {
-			for (uint32_t j = i, p = k = i + m; j < p; ++j, ++k) {
-				double t = angles.at(j);
-				angles.at(j) += angles.at(k);
-				angles.at(k) = t - angles.at(k);
-			}
-		}
-	}
-}
-
 } // namespace diagonal_synth_detail
 #pragma endregion
 
-inline void diagonal_synth(Circuit& circuit, std::vector<WireRef> qubits,
-    std::vector<double> const& angles)
+/*! \brief Synthesis of diagonal unitaries.
+ *
+ * The diagonal is given by the angles of its entries: entry ``x`` is
+ * ``e^(i * angles[x])``, where bit ``j`` of ``x`` is the value of qubit ``j``.
+ * Its phase polynomial is computed with a Walsh-Hadamard transform, and every
+ * term whose angle magnitude is at most ``epsilon`` is dropped.
+ *
+ * \param[inout] circuit A circuit in which the diagonal will be synthesized on.
+ * \param[in] qubits The qubits that will be used.
+ * \param[in] angles The 2^n angles of the diagonal.
+ * \param[in] epsilon (optional) Threshold below which terms are dropped.
+ * \return A bound on the operator norm of the difference between the
+ * synthesized and the given diagonal (up to a global phase): the sum of the
+ * magnitudes of the dropped angles, capped at 2.
+ */
+inline double diagonal_synth(Circuit& circuit, std::vector<WireRef> qubits,
+    std::vector<double> const& angles, double epsilon = 0.0)
 {
 	// Number of angles + 1 needs to be a power of two!
 	assert(!angles.empty() && !(angles.size() & (angles.size() - 1)));
@@ -79,24 +71,38 @@ inline void diagonal_synth(Circuit& circuit, std::vector<WireRef> qubits,
 
 	std::vector<double> new_angles
 	    = diagonal_synth_detail::fix_angles(qubits, angles);
-	diagonal_synth_detail::fast_hadamard_transform(new_angles);
+	walsh_hadamard_transform(new_angles);
 	LinearPP parities;
-	uint32_t factor = (1 << (qubits.size() - 1));
-	for (uint32_t i = 0u; i < new_angles.size(); ++i) {
-		if (new_angles.at(i) == 0) {
+	parities.reserve(new_angles.size() - 1u);
+	double const factor = (1u << (qubits.size() - 1));
+	double error = 0.0;
+	// The constant term is a global phase.
+	for (uint32_t i = 1u; i < new_angles.size(); ++i) {
+		double const angle = new_angles[i] / factor;
+		if (std::abs(angle) <= epsilon) {
+			error += std::abs(angle);
 			continue;
 		}
-		parities.add_term(i, new_angles.at(i) / factor);
+		parities.append_term(i, angle);
 	}
-	if (parities.size() == new_angles.size()) {
+	if (parities.size() == new_angles.size() - 1u) {
 		all_linear_synth(circuit, qubits, parities);
 	} else {
 		gray_synth(circuit, qubits,
-		    Matrix<uint8_t>::Identity(qubits.size()), parities);
+		    BitMatrix::Identity(qubits.size()), parities);
 	}
+	return std::min(2.0, error);
 }
 
-inline Circuit diagonal_synth(std::vector<double> const& angles)
+/*! \brief Synthesis of diagonal unitaries.
+ *
+ * \param[in] angles The 2^n angles of the diagonal.
+ * \param[in] epsilon (optional) Threshold below which terms are dropped, see
+ * the in-place variant, which also returns the resulting error bound.
+ * \return A circuit on n qubits.
+ */
+inline Circuit diagonal_synth(
+    std::vector<double> const& angles, double epsilon = 0.0)
 {
 	// Number of angles + 1 needs to be a power of two!
 	assert(!angles.empty() && !(angles.size() & (angles.size() - 1)));
@@ -111,7 +117,86 @@ inline Circuit diagonal_synth(std::vector<double> const& angles)
 	for (uint32_t i = 0u; i < num_qubits; ++i) {
 		wires.emplace_back(circuit.create_qubit());
 	}
-	diagonal_synth(circuit, wires, angles);
+	diagonal_synth(circuit, wires, angles, epsilon);
+	return circuit;
+}
+
+/*! \brief Synthesis of diagonal unitaries given by a phase polynomial.
+ *
+ * The diagonal is given by the terms of its phase polynomial: entry ``x`` is
+ * ``e^(i * sum(angle * (parity . x)))``, where bit ``j`` of a parity selects
+ * qubit ``j``.  Unlike the dense variant, the 2^n entries are never built, so
+ * diagonals on many qubits can be synthesized as long as they have few terms.
+ * Every term whose angle magnitude is at most ``epsilon`` is dropped.
+ *
+ * \param[inout] circuit A circuit in which the diagonal will be synthesized on.
+ * \param[in] qubits The qubits that will be used.
+ * \param[in] parities The terms of the phase polynomial.
+ * \param[in] epsilon (optional) Threshold below which terms are dropped.
+ * \return A bound on the operator norm of the difference between the
+ * synthesized and the given diagonal (up to a global phase): the sum of the
+ * magnitudes of the dropped angles, capped at 2.
+ */
+template<typename Parity>
+inline double diagonal_synth(Circuit& circuit, std::vector<WireRef> qubits,
+    LinearPP<Parity> const& parities, double epsilon = 0.0)
+{
+	assert(!qubits.empty());
+	// On a complemented qubit, x becomes 1 - x: a term depending on an odd
+	// number of those turns into a global phase minus the same term.
+	std::vector<uint32_t> complemented;
+	for (uint32_t i = 0u; i < qubits.size(); ++i) {
+		if (qubits[i].is_complemented()) {
+			qubits[i].complement();
+			complemented.push_back(i);
+		}
+	}
+	LinearPP<Parity> terms;
+	double error = 0.0;
+	for (auto const& [parity, angle] : parities) {
+		bool is_constant = true;
+		for (uint32_t i = 0u; i < qubits.size() && is_constant; ++i) {
+			is_constant = !parity_has_var(parity, i);
+		}
+		// The constant term is a global phase.
+		if (is_constant) {
+			continue;
+		}
+		if (std::abs(angle) <= epsilon) {
+			error += std::abs(angle);
+			continue;
+		}
+		bool negate = false;
+		for (uint32_t i : complemented) {
+			negate ^= parity_has_var(parity, i);
+		}
+		terms.add_term(parity, negate ? -angle : angle);
+	}
+	gray_synth(circuit, qubits, BitMatrix::Identity(qubits.size()), terms);
+	return std::min(2.0, error);
+}
+
+/*! \brief Synthesis of diagonal unitaries given by a phase polynomial.
+ *
+ * \param[in] num_qubits The number of qubits of the diagonal.
+ * \param[in] parities The terms of the phase polynomial.
+ * \param[in] epsilon (optional) Threshold below which terms are dropped, see
+ * the in-place variant, which also returns the resulting error bound.
+ * \return A circuit on ``num_qubits`` qubits.
+ */
+template<typename Parity>
+inline Circuit diagonal_synth(uint32_t num_qubits,
+    LinearPP<Parity> const& parities, double epsilon = 0.0)
+{
+	// TODO: method to generate a name;
+	Circuit circuit("my_circuit");
+	// Create the necessary qubits
+	std::vector<WireRef> wires;
+	wires.reserve(num_qubits);
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		wires.emplace_back(circuit.create_qubit());
+	}
+	diagonal_synth(circuit, wires, parities, epsilon);
 	return circuit;
 }
 
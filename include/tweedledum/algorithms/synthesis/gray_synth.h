@@ -7,10 +7,21 @@
 #include "../../ir/Circuit.h"
 #include "../../ir/GateLib.h"
 #include "../../ir/Wire.h"
+#include "../../support/BitMatrix.h"
+#include "../../support/DynamicBitset.h"
 #include "../../support/LinearPP.h"
 #include "../../support/Matrix.h"
+#include "../../support/ThreadPool.h"
 #include "cnot_synth.h"
 
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <vector>
+
 // This implementation is based on:
 //
 // Amy, Matthew, Parsiad Azimzadeh, and Michele Mosca. "On the controlled-NOT
@@ -36,150 +47,234 @@ namespace gray_synth_detail {
 using AbstractGate = std::pair<uint32_t, uint32_t>;
 using GateList = std::vector<AbstractGate>;
 
+// The set of columns (parities) of a state is a range of `Workspace::columns`.
+// Cofactoring a state partitions its range in place, so sibling states own
+// disjoint ranges and column sets are never copied.  Likewise, the rows that
+// remain to be selected are `Workspace::rows[depth, num_rows)`: selecting a
+// row swaps it to position `depth`, which only reorders rows that are still
+// remaining for every state on the stack.
 struct State {
-	std::vector<uint32_t> sel_cols;
-	std::vector<uint32_t> rem_rows;
+	uint32_t begin;
+	uint32_t end;
+	uint32_t depth;
 	uint32_t qubit;
+};
+
+// How a state selects the row (qubit) on which its columns are cofactored.
+// The chosen row is the one with the most ones or zeros, either in the whole
+// row or among the columns of the state only (as in the paper).
+enum class RowRule : uint8_t {
+	whole_row,
+	state_columns,
+};
+
+enum class TieBreak : uint8_t {
+	lowest_index,
+	highest_index,
+	random,
+};
+
+struct Config {
+	RowRule rule = RowRule::whole_row;
+	TieBreak tie_break = TieBreak::lowest_index;
+	uint32_t seed = 0u;
+};
 
-	State(std::vector<uint32_t> const& sel_cols,
-	    std::vector<uint32_t> const& rem_rows, uint32_t qubit)
-	    : sel_cols(sel_cols), rem_rows(rem_rows), qubit(qubit)
-	{}
+struct Workspace {
+	BitMatrix& matrix;
+	Config config;
+	std::mt19937 rng;
+	std::vector<uint32_t> columns;
+	std::vector<uint32_t> rows;
+	std::vector<uint32_t> row_weights;
+	std::vector<State> stack;
+
+	Workspace(BitMatrix& matrix, Config const& config)
+	    : matrix(matrix), config(config), rng(config.seed),
+	      columns(matrix.num_columns()), rows(matrix.num_rows()),
+	      row_weights(matrix.num_rows())
+	{
+		std::iota(columns.begin(), columns.end(), 0u);
+		std::iota(rows.begin(), rows.end(), 0u);
+		for (uint32_t i = 0u; i < matrix.num_rows(); ++i) {
+			row_weights[i] = matrix.row_weight(i);
+		}
+		stack.reserve(matrix.num_rows() + 2u);
+	}
 };
 
-template<typename T>
-uint32_t select_row(State& state, Matrix<T> const& matrix)
+inline uint32_t row_score(State const& state, Workspace& ws, uint32_t row)
 {
-	assert(!state.rem_rows.empty());
-	uint32_t sel_row = 0;
-	uint32_t max = 0;
+	uint32_t num_ones = 0u;
+	uint32_t num_columns = 0u;
+	if (ws.config.rule == RowRule::whole_row) {
+		num_ones = ws.row_weights[row];
+		num_columns = ws.matrix.num_columns();
+	} else {
+		num_ones = std::count_if(ws.columns.begin() + state.begin,
+		    ws.columns.begin() + state.end,
+		    [&](uint32_t col) { return ws.matrix(row, col); });
+		num_columns = state.end - state.begin;
+	}
+	return std::max(num_ones, num_columns - num_ones);
+}
 
-	for (uint32_t row_idx : state.rem_rows) {
-		auto row = matrix.row(row_idx);
-		uint32_t num_ones = row.sum();
-		uint32_t num_zeros = matrix.num_columns() - num_ones;
-		uint32_t local_max = std::max(num_ones, num_zeros);
+// Selects, among the remaining rows, the one with the highest score, breaking
+// ties according to the configuration, and moves it to position `depth`.
+inline uint32_t select_row(State const& state, Workspace& ws)
+{
+	assert(state.depth < ws.rows.size());
+	uint32_t sel_idx = state.depth;
+	uint32_t max = 0;
+	uint32_t num_ties = 0;
+	for (uint32_t idx = state.depth; idx < ws.rows.size(); ++idx) {
+		uint32_t const row = ws.rows[idx];
+		uint32_t const local_max = row_score(state, ws, row);
+		if (local_max < max) {
+			continue;
+		}
 		if (local_max > max) {
 			max = local_max;
-			sel_row = row_idx;
+			sel_idx = idx;
+			num_ties = 1u;
+			continue;
+		}
+		++num_ties;
+		switch (ws.config.tie_break) {
+		case TieBreak::lowest_index:
+			sel_idx = row < ws.rows[sel_idx] ? idx : sel_idx;
+			break;
+
+		case TieBreak::highest_index:
+			sel_idx = row > ws.rows[sel_idx] ? idx : sel_idx;
+			break;
+
+		case TieBreak::random:
+			// Reservoir sampling: each tie is kept with equal odds
+			if (ws.rng() % num_ties == 0u) {
+				sel_idx = idx;
+			}
+			break;
 		}
 	}
-	return sel_row;
+	std::swap(ws.rows[state.depth], ws.rows[sel_idx]);
+	return ws.rows[state.depth];
 }
 
-template<typename T>
-inline void add_gate(State& state, Matrix<T>& matrix, GateList& gates)
+inline void add_gate(State const& state, Workspace& ws, GateList& gates)
 {
-	for (uint32_t j = 0u; j < matrix.num_rows(); ++j) {
+	auto const begin = ws.columns.begin() + state.begin;
+	auto const end = ws.columns.begin() + state.end;
+	for (uint32_t j = 0u; j < ws.matrix.num_rows(); ++j) {
 		if (j == state.qubit) {
 			continue;
 		}
-		bool all_one = true;
-		for (uint32_t col : state.sel_cols) {
-			all_one &= (matrix(j, col) == 1);
-		}
+		bool const all_one = std::all_of(begin, end,
+		    [&](uint32_t col) { return ws.matrix(j, col); });
 		if (!all_one) {
 			continue;
 		}
-		matrix.row(j) ^= std::valarray(matrix.row(state.qubit));
+		ws.matrix.row_xor(j, state.qubit);
+		ws.row_weights[j] = ws.matrix.row_weight(j);
 		gates.emplace_back(j, state.qubit);
 	}
 }
 
-template<typename T>
-GateList synthesize(std::vector<WireRef> const& qubits, Matrix<T>& matrix)
+inline GateList synthesize(std::vector<WireRef> const& qubits,
+    BitMatrix& matrix, Config const& config = {})
 {
 	GateList gates;
 	uint32_t const num_qubits = qubits.size();
+	Workspace ws(matrix, config);
 
 	// Initial state
-	std::vector<State> state_stack(1, {{}, {}, num_qubits});
-	State& init_state = state_stack.back();
-	init_state.sel_cols.resize(matrix.num_columns());
-	init_state.rem_rows.resize(matrix.num_rows());
-	std::iota(init_state.sel_cols.begin(), init_state.sel_cols.end(), 0u);
-	std::iota(init_state.rem_rows.begin(), init_state.rem_rows.end(), 0u);
-
-	while (!state_stack.empty()) {
-		State state = std::move(state_stack.back());
-		state_stack.pop_back();
+	ws.stack.push_back({0u, matrix.num_columns(), 0u, num_qubits});
+	while (!ws.stack.empty()) {
+		State const state = ws.stack.back();
+		ws.stack.pop_back();
 		if (state.qubit != num_qubits) {
-			add_gate(state, matrix, gates);
+			add_gate(state, ws, gates);
 		}
 
-		auto temp = std::valarray(matrix.column(state.sel_cols.back()));
-		if (state.sel_cols.size() == 1 && temp.sum() <= 1) {
+		if (state.end - state.begin == 1
+		    && matrix.column_weight(ws.columns[state.begin]) <= 1) {
 			continue;
 		}
-		if (state.rem_rows.empty()) {
+		if (state.depth == ws.rows.size()) {
 			continue;
 		}
 
-		uint32_t sel_row = select_row(state, matrix);
-		std::vector<uint32_t> cofactor0;
-		std::vector<uint32_t> cofactor1;
-		for (uint32_t col : state.sel_cols) {
-			if (matrix(sel_row, col)) {
-				cofactor1.push_back(col);
-				continue;
-			}
-			cofactor0.push_back(col);
-		}
-		std::remove(
-		    state.rem_rows.begin(), state.rem_rows.end(), sel_row);
-		state.rem_rows.pop_back();
-		if (!cofactor1.empty()) {
-			state_stack.emplace_back(std::move(cofactor1),
-			    state.rem_rows,
-			    (state.qubit == num_qubits) ? sel_row : state.qubit);
+		uint32_t const sel_row = select_row(state, ws);
+		// Cofactor 0 goes to [begin, middle), cofactor 1 to [middle, end)
+		auto const middle = std::partition(
+		    ws.columns.begin() + state.begin,
+		    ws.columns.begin() + state.end,
+		    [&](uint32_t col) { return !matrix(sel_row, col); });
+		uint32_t const mid = middle - ws.columns.begin();
+		if (mid != state.end) {
+			ws.stack.push_back({mid, state.end, state.depth + 1u,
+			    (state.qubit == num_qubits) ? sel_row : state.qubit});
 		}
-		if (!cofactor0.empty()) {
-			state_stack.emplace_back(
-			    std::move(cofactor0), state.rem_rows, state.qubit);
+		if (mid != state.begin) {
+			ws.stack.push_back(
+			    {state.begin, mid, state.depth + 1u, state.qubit});
 		}
 	}
 	return gates;
 }
 
-} // namespace gray_synth_detail
-#pragma endregion
-
-/*! \brief Synthesis of a CNOT-dihedral circuits with all linear combinations.
- *
- * This is the in-place variant of ``all_linear_synth`` in which the circuit is
- * passed as a parameter and can potentially already contain some gates.  The
- * parameter ``qubits`` provides a qubit mapping to the existing qubits in the
- * circuit.
- * 
- * \param[inout] circuit A circuit in which the parities will be synthesized on.
- * \param[in] qubits The qubits that will be used.
- * \param[in] linear_trans The overall linear transformation
- * \param[in] parities List of parities and their associated angles.
- */
-// Each column is a parity, num_rows = num_qubits
-template<typename T, typename Parity>
-inline void gray_synth(Circuit& circuit, std::vector<WireRef> const& qubits,
-    Matrix<T> linear_trans, LinearPP<Parity> parities)
+// Each parity is a column of the returned matrix, num_rows = num_qubits
+template<typename Parity>
+inline BitMatrix parities_matrix(
+    LinearPP<Parity> const& parities, uint32_t num_qubits)
 {
-	// FIXME: This part assumes that Parity is a bit string implemented 
-	// using an integer type such as uint32_t or uint64_t, or a
-	// a DynamicBitset.
-	Matrix<uint8_t> parities_matrix(qubits.size(), parities.size());
-	uint32_t col = 0;
+	// Each parity is a row of this matrix, and thus a column once transposed.
+	BitMatrix parities_rows(parities.size(), num_qubits);
+	uint32_t row = 0;
 	for (auto const& [parity, angle] : parities) {
-		for (uint32_t row = 0; row < qubits.size(); ++row) {
-			parities_matrix(row, col) = (parity >> row) & 1;
+		if constexpr (std::is_same_v<Parity, DynamicBitset<uint64_t>>) {
+			assert(parity.size() == num_qubits);
+			std::copy_n(parity.data(), parities_rows.row_words(),
+			    parities_rows.row_data(row));
+		} else {
+			for (uint32_t col = 0; col < num_qubits; ++col) {
+				parities_rows.set(
+				    row, col, parity_has_var(parity, col));
+			}
 		}
-		++col;
+		++row;
 	}
+	return transpose(parities_rows);
+}
+
+// Turns `linear_trans` into the linear transformation that remains to be
+// synthesized after `gates`, i.e., `linear_trans * G^-1` where G is the
+// transformation implemented by the gates.  CNOTs are self-inverse, so each
+// one is a column operation.
+inline void remove_gates(BitMatrix& linear_trans, GateList const& gates)
+{
+	for (auto const& [control, target] : gates) {
+		for (uint32_t i = 0u; i < linear_trans.num_rows(); ++i) {
+			if (linear_trans(i, target)) {
+				linear_trans.flip(i, control);
+			}
+		}
+	}
+}
 
-	auto gates = gray_synth_detail::synthesize(qubits, parities_matrix);
+// Adds the gates to the circuit, each phase gate right after the gate that
+// makes its parity appear on a qubit.
+template<typename Parity>
+inline void add_gates(Circuit& circuit, std::vector<WireRef> const& qubits,
+    GateList const& gates, LinearPP<Parity>& parities)
+{
 	// Initialize the parity of each qubit state
 	// Applying phase gate to parities that consisting of just one variable
 	// i is the index of the target
-	std::vector<uint32_t> qubits_states(circuit.num_qubits(), 0);
-	for (uint32_t i = 0u; i < circuit.num_qubits(); ++i) {
-		qubits_states[i] = (1u << i);
+	std::vector<Parity> qubits_states;
+	qubits_states.reserve(qubits.size());
+	for (uint32_t i = 0u; i < qubits.size(); ++i) {
+		qubits_states.push_back(parity_var<Parity>(qubits.size(), i));
 		auto angle = parities.extract_term(qubits_states[i]);
 		if (angle != 0.0) {
 			circuit.create_instruction(
@@ -191,17 +286,54 @@ inline void gray_synth(Circuit& circuit, std::vector<WireRef> const& qubits,
 		circuit.create_instruction(
 		    GateLib::X(), {qubits[control]}, qubits[target]);
 		qubits_states[target] ^= qubits_states[control];
-		linear_trans.row(target) ^= std::valarray(linear_trans.row(control));
 		auto angle = parities.extract_term(qubits_states[target]);
 		if (angle != 0.0) {
 			circuit.create_instruction(
 			    GateLib::R1(angle), {qubits[target]});
 		}
 	}
+}
+
+} // namespace gray_synth_detail
+#pragma endregion
+
+/*! \brief Synthesis of a CNOT-dihedral circuits with all linear combinations.
+ *
+ * This is the in-place variant of ``all_linear_synth`` in which the circuit is
+ * passed as a parameter and can potentially already contain some gates.  The
+ * parameter ``qubits`` provides a qubit mapping to the existing qubits in the
+ * circuit.
+ * 
+ * \param[inout] circuit A circuit in which the parities will be synthesized on.
+ * \param[in] qubits The qubits that will be used.
+ * \param[in] linear_trans The overall linear transformation
+ * \param[in] parities List of parities and their associated angles.
+ */
+// Each column is a parity, num_rows = num_qubits
+template<typename Parity>
+inline void gray_synth(Circuit& circuit, std::vector<WireRef> const& qubits,
+    BitMatrix linear_trans, LinearPP<Parity> parities)
+{
+	using namespace gray_synth_detail;
+	// Sort the parities, so that the result does not depend on the order in
+	// which the terms were added.
+	parities.finalize();
+	BitMatrix parities_matrix
+	    = gray_synth_detail::parities_matrix(parities, qubits.size());
+	GateList const gates = synthesize(qubits, parities_matrix);
+	add_gates(circuit, qubits, gates, parities);
 	// Synthesize the overall linear transformation
+	remove_gates(linear_trans, gates);
 	cnot_synth(circuit, qubits, linear_trans);
 }
 
+template<typename T, typename Parity>
+inline void gray_synth(Circuit& circuit, std::vector<WireRef> const& qubits,
+    Matrix<T> const& linear_trans, LinearPP<Parity> const& parities)
+{
+	gray_synth(circuit, qubits, BitMatrix(linear_trans), parities);
+}
+
 /*! \brief Synthesis of a CNOT-dihedral circuits.
  *
  * \param[in] num_qubits The number of qubits.
@@ -221,12 +353,121 @@ inline Circuit gray_synth(uint32_t num_qubits, LinearPP<Parity> const& parities)
 		wires.emplace_back(circuit.create_qubit());
 	}
 
-	// Create the linear
-	Matrix<uint8_t> linear_trans(num_qubits, num_qubits);
-	for (uint32_t i = 0; i < num_qubits; ++i) {
-		linear_trans(i, i) = 1;
+	gray_synth(circuit, wires, BitMatrix::Identity(num_qubits), parities);
+	return circuit;
+}
+
+/*! \brief Portfolio synthesis of a CNOT-dihedral circuits.
+ *
+ * The number of CNOTs generated by ``gray_synth`` depends a lot on how rows are
+ * selected, and on how ties between them are broken.  This variant runs
+ * ``gray_synth`` under several row selection and tie-breaking policies
+ * concurrently, and keeps the circuit with fewest CNOTs, counting those
+ * needed for the overall linear transformation.
+ *
+ * The policy used by ``gray_synth`` always runs, so the result is never worse.
+ * The ``num_random_runs`` random tie-breaking runs are seeded from ``seed``,
+ * so the result is deterministic unless the time budget runs out.
+ *
+ * \param[inout] circuit A circuit in which the parities will be synthesized on.
+ * \param[in] qubits The qubits that will be used.
+ * \param[in] linear_trans The overall linear transformation
+ * \param[in] parities List of parities and their associated angles.
+ * \param[in] num_random_runs Number of runs with random tie-breaking.
+ * \param[in] seed Seed of the random tie-breaking.
+ * \param[in] num_threads Number of threads (0 means one per hardware thread).
+ * \param[in] time_budget (optional) Policies that did not start within this
+ * time are skipped, 0 means no limit.
+ */
+template<typename Parity>
+inline void gray_synth_portfolio(Circuit& circuit,
+    std::vector<WireRef> const& qubits, BitMatrix const& linear_trans,
+    LinearPP<Parity> parities, uint32_t num_random_runs = 8u,
+    uint32_t seed = 1u, uint32_t num_threads = 0u,
+    std::chrono::milliseconds time_budget = std::chrono::milliseconds(0))
+{
+	using namespace gray_synth_detail;
+	using Clock = std::chrono::steady_clock;
+	parities.finalize();
+	BitMatrix const parities_matrix
+	    = gray_synth_detail::parities_matrix(parities, qubits.size());
+
+	std::vector<Config> configs;
+	for (RowRule rule : {RowRule::whole_row, RowRule::state_columns}) {
+		for (TieBreak tie_break :
+		    {TieBreak::lowest_index, TieBreak::highest_index}) {
+			configs.push_back({rule, tie_break, 0u});
+		}
+	}
+	std::mt19937 gen(seed);
+	for (uint32_t i = 0u; i < num_random_runs; ++i) {
+		RowRule const rule
+		    = (i & 1u) ? RowRule::whole_row : RowRule::state_columns;
+		configs.push_back(
+		    {rule, TieBreak::random, static_cast<uint32_t>(gen())});
+	}
+
+	struct Result {
+		bool done = false;
+		GateList gates;
+		GateList linear_gates;
+	};
+	auto const start = Clock::now();
+	std::vector<Result> results(configs.size());
+	ThreadPool pool(num_threads);
+	pool.parallel_for(configs.size(), [&](uint32_t i) {
+		if (i != 0u && time_budget.count() > 0
+		    && Clock::now() - start > time_budget) {
+			return;
+		}
+		BitMatrix matrix = parities_matrix;
+		results[i].gates = synthesize(qubits, matrix, configs[i]);
+		BitMatrix rest = linear_trans;
+		remove_gates(rest, results[i].gates);
+		results[i].linear_gates = cnot_synth_detail::synthesize(rest, 0u);
+		results[i].done = true;
+	});
+
+	auto const num_cnots = [](Result const& result) {
+		return result.gates.size() + result.linear_gates.size();
+	};
+	Result const* best = &results[0];
+	for (Result const& result : results) {
+		if (result.done && num_cnots(result) < num_cnots(*best)) {
+			best = &result;
+		}
+	}
+	add_gates(circuit, qubits, best->gates, parities);
+	cnot_synth_detail::add_gates(circuit, qubits, best->linear_gates);
+}
+
+/*! \brief Portfolio synthesis of a CNOT-dihedral circuits.
+ *
+ * \param[in] num_qubits The number of qubits.
+ * \param[in] parities List of parities and their associated angles.
+ * \param[in] num_random_runs Number of runs with random tie-breaking.
+ * \param[in] seed Seed of the random tie-breaking.
+ * \param[in] num_threads Number of threads (0 means one per hardware thread).
+ * \param[in] time_budget (optional) 0 means no limit.
+ * \return A CNOT-dihedral circuit on `num_qubits`.
+ */
+template<typename Parity>
+inline Circuit gray_synth_portfolio(uint32_t num_qubits,
+    LinearPP<Parity> const& parities, uint32_t num_random_runs = 8u,
+    uint32_t seed = 1u, uint32_t num_threads = 0u,
+    std::chrono::milliseconds time_budget = std::chrono::milliseconds(0))
+{
+	// TODO: method to generate a name;
+	Circuit circuit("my_circuit");
+
+	// Create the necessary qubits
+	std::vector<WireRef> wires;
+	wires.reserve(num_qubits);
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		wires.emplace_back(circuit.create_qubit());
 	}
-	gray_synth(circuit, wires, linear_trans, parities);
+	gray_synth_portfolio(circuit, wires, BitMatrix::Identity(num_qubits),
+	    parities, num_random_runs, seed, num_threads, time_budget);
 	return circuit;
 }
 
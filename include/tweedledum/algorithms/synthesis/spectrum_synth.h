@@ -7,11 +7,16 @@
 #include "../../ir/Circuit.h"
 #include "../../ir/GateLib.h"
 #include "../../ir/Wire.h"
+#include "../../support/BitMatrix.h"
 #include "../../support/LinearPP.h"
+#include "../../support/WalshHadamard.h"
 #include "gray_synth.h"
 #include "all_linear_synth.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <kitty/kitty.hpp>
 #include <vector>
 
@@ -19,37 +24,98 @@ namespace tweedledum {
 
 using TruthTable = kitty::dynamic_truth_table;
 
-inline void spectrum_synth(Circuit& circuit, std::vector<WireRef> const& qubits,
-    TruthTable const& function)
+#pragma region Implementation details
+namespace spectrum_synth_detail {
+
+// Rademacher-Walsh spectrum of `function`: S(w) = sum_x (-1)^(f(x) + w . x)
+inline std::vector<int32_t> spectrum(TruthTable const& function)
+{
+	uint32_t const size = (1u << function.num_vars());
+	std::vector<int32_t> result(size);
+	auto word = function.cbegin();
+	for (uint32_t x = 0u; x < size; x += 64u, ++word) {
+		uint32_t const end = std::min(size, x + 64u);
+		for (uint32_t i = x; i < end; ++i) {
+			result[i] = 1 - 2 * int32_t((*word >> (i - x)) & 1u);
+		}
+	}
+	walsh_hadamard_transform(result);
+	return result;
+}
+
+// The oracle needs the spectrum of g(x, y) = f(x) * y, where y is variable n.
+// Summing over y gives it from the spectrum of f:
+//     S_g(w, b) = 2^n * [w = 0] + (-1)^b * S_f(w)
+inline int32_t oracle_coefficient(
+    std::vector<int32_t> const& spectrum, uint32_t w, bool b)
 {
+	int32_t const constant = (w == 0u) ? int32_t(spectrum.size()) : 0;
+	return b ? constant - spectrum[w] : constant + spectrum[w];
+}
+
+} // namespace spectrum_synth_detail
+#pragma endregion
+
+/*! \brief Spectrum-based synthesis of single-target gates.
+ *
+ * Synthesizes the oracle |x, y> -> |x, y ^ f(x)> as the diagonal
+ * (-1)^(f(x) * y) conjugated by Hadamard gates on the target.  The angle of
+ * each parity is proportional to a coefficient of the Rademacher-Walsh
+ * spectrum of f(x) * y, and every term whose angle magnitude is at most
+ * ``epsilon`` is dropped.
+ *
+ * \param[inout] circuit A circuit in which the function will be synthesized on.
+ * \param[in] qubits The qubits that will be used, the last one is the target.
+ * \param[in] function A Boolean function.
+ * \param[in] epsilon (optional) Threshold below which terms are dropped.
+ * \return A bound on the operator norm of the difference between the
+ * synthesized and the exact oracle (up to a global phase): the sum of the
+ * magnitudes of the dropped angles, capped at 2.
+ */
+inline double spectrum_synth(Circuit& circuit,
+    std::vector<WireRef> const& qubits, TruthTable const& function,
+    double epsilon = 0.0)
+{
+	using namespace spectrum_synth_detail;
 	uint32_t const num_controls = function.num_vars();
 	assert(qubits.size() >= (num_controls + 1u));
 
-	auto extended_f = kitty::extend_to(function, num_controls + 1);
-	auto g = extended_f.construct();
-	kitty::create_nth_var(g, num_controls);
-	extended_f &= g;
-
 	LinearPP parities;
-	uint32_t const norm = (1 << extended_f.num_vars());
-	auto const spectrum = kitty::rademacher_walsh_spectrum(extended_f);
-	for (uint32_t i = 1u; i < spectrum.size(); ++i) {
-		if (spectrum[i] == 0) {
+	auto const spectrum = spectrum_synth_detail::spectrum(function);
+	uint32_t const num_parities = (2u << num_controls);
+	double const norm = num_parities;
+	parities.reserve(num_parities - 1u);
+	double error = 0.0;
+	for (uint32_t i = 1u; i < num_parities; ++i) {
+		bool const b = (i >> num_controls) & 1u;
+		uint32_t const w = i & (spectrum.size() - 1u);
+		double const angle
+		    = M_PI * oracle_coefficient(spectrum, w, b) / norm;
+		if (std::abs(angle) <= epsilon) {
+			error += std::abs(angle);
 			continue;
 		}
-		parities.add_term(i, norm * spectrum[i]);
+		parities.append_term(i, angle);
 	}
 	circuit.create_instruction(GateLib::H(), {qubits.back()});
-	if (parities.size() == spectrum.size() - 1) {
+	if (parities.size() == num_parities - 1u) {
 		all_linear_synth(circuit, qubits, parities);
 	} else {
 		gray_synth(circuit, qubits,
-		    Matrix<uint8_t>::Identity(qubits.size()), parities);
+		    BitMatrix::Identity(qubits.size()), parities);
 	}
 	circuit.create_instruction(GateLib::H(), {qubits.back()});
+	return std::min(2.0, error);
 }
 
-inline Circuit spectrum_synth(TruthTable const& function)
+/*! \brief Spectrum-based synthesis of single-target gates.
+ *
+ * \param[in] function A Boolean function of n variables.
+ * \param[in] epsilon (optional) Threshold below which terms are dropped, see
+ * the in-place variant, which also returns the resulting error bound.
+ * \return A circuit on n + 1 qubits, the last one being the target.
+ */
+inline Circuit spectrum_synth(TruthTable const& function, double epsilon = 0.0)
 {
 	// TODO: method to generate a name;
 	Circuit circuit("my_circuit");
@@ -59,7 +125,7 @@ inline Circuit spectrum_synth(TruthTable const& function)
 	for (uint32_t i = 0u; i < function.num_vars() + 1; ++i) {
 		wires.emplace_back(circuit.create_qubit());
 	}
-	spectrum_synth(circuit, wires, function);
+	spectrum_synth(circuit, wires, function, epsilon);
 	return circuit;
 }
 
@@ -0,0 +1,237 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../ir/Circuit.h"
+#include "../../ir/Operator.h"
+#include "../../ir/Wire.h"
+#include "../../support/LruCache.h"
+#include "diagonal_synth.h"
+#include "spectrum_synth.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <kitty/kitty.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tweedledum {
+#pragma region Implementation details
+namespace synthesis_cache_detail {
+
+enum class Method : uint8_t {
+	diagonal,
+	spectrum,
+};
+
+// Everything the synthesized gates depend on.  The payload holds either the
+// bit patterns of the angles or the words of the truth table.
+struct Key {
+	Method method;
+	uint32_t num_qubits;
+	uint64_t polarity;
+	uint64_t epsilon;
+	std::vector<uint64_t> payload;
+
+	bool operator==(Key const& other) const
+	{
+		return method == other.method && num_qubits == other.num_qubits
+		       && polarity == other.polarity && epsilon == other.epsilon
+		       && payload == other.payload;
+	}
+};
+
+struct KeyHash {
+	std::size_t operator()(Key const& key) const
+	{
+		std::size_t seed = kitty::hash_block(key.num_qubits);
+		kitty::hash_combine(seed, static_cast<std::size_t>(key.method));
+		kitty::hash_combine(seed, kitty::hash_block(key.polarity));
+		kitty::hash_combine(seed, kitty::hash_block(key.epsilon));
+		for (uint64_t word : key.payload) {
+			kitty::hash_combine(seed, kitty::hash_block(word));
+		}
+		return seed;
+	}
+};
+
+// The gates are kept in a circuit whose qubit `i` stands for the caller's
+// qubit `i`.
+struct Entry {
+	Circuit gates;
+	double error;
+};
+
+inline uint64_t to_bits(double value)
+{
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+inline Key make_key(Method method, std::vector<WireRef> const& qubits,
+    double epsilon, std::vector<uint64_t> payload)
+{
+	assert(qubits.size() <= 64u);
+	uint64_t polarity = 0u;
+	for (uint32_t i = 0u; i < qubits.size(); ++i) {
+		if (qubits[i].polarity() == WireRef::Polarity::negative) {
+			polarity |= (uint64_t(1) << i);
+		}
+	}
+	return {method, static_cast<uint32_t>(qubits.size()), polarity,
+	    to_bits(epsilon), std::move(payload)};
+}
+
+// Creates a circuit with as many qubits as `qubits`, complemented alike.
+inline std::vector<WireRef> make_scratch(
+    Circuit& scratch, std::vector<WireRef> const& qubits)
+{
+	std::vector<WireRef> wires;
+	wires.reserve(qubits.size());
+	for (WireRef qubit : qubits) {
+		WireRef const wire = scratch.create_qubit();
+		wires.push_back(qubit.is_complemented() ? !wire : wire);
+	}
+	return wires;
+}
+
+// Adds the gates of `entry` to `circuit`, on `qubits`.
+inline void replay(Circuit& circuit, std::vector<WireRef> const& qubits,
+    Entry const& entry)
+{
+	std::vector<WireRef> wires;
+	for (Instruction const& inst : entry.gates) {
+		wires.clear();
+		for (WireRef wire : inst) {
+			WireRef qubit = qubits.at(wire.uid());
+			if (qubit.is_complemented() != wire.is_complemented()) {
+				qubit.complement();
+			}
+			wires.push_back(qubit);
+		}
+		circuit.create_instruction(
+		    static_cast<Operator const&>(inst), wires);
+	}
+}
+
+} // namespace synthesis_cache_detail
+#pragma endregion
+
+/*! \brief A size-bounded cache of diagonal and spectrum synthesis results.
+ *
+ * Oracle-heavy workloads often synthesize the same diagonal or the same
+ * Boolean function many times.  This cache sits in front of `diagonal_synth`
+ * and `spectrum_synth`: it keys each request by its input (the angles or the
+ * truth table), the threshold and the polarity of the qubits, and keeps the
+ * synthesized gates of the least recently used ``capacity`` requests.  On a
+ * hit, the gates are added to the circuit on the caller's qubits, without
+ * running the synthesis again.  The result is the same as calling the
+ * synthesis method directly.
+ *
+ * The cache can be shared between threads.  Two threads missing on the same
+ * key at once will both synthesize it.
+ */
+class SynthesisCache {
+	using Key = synthesis_cache_detail::Key;
+	using Entry = synthesis_cache_detail::Entry;
+	using Cache = LruCache<Key, std::shared_ptr<Entry const>,
+	    synthesis_cache_detail::KeyHash>;
+
+public:
+	using Stats = Cache::Stats;
+
+	SynthesisCache(uint32_t capacity = 256u) : cache_(capacity)
+	{}
+
+	/*! \brief Cached `diagonal_synth`, see its documentation. */
+	double diagonal_synth(Circuit& circuit, std::vector<WireRef> const& qubits,
+	    std::vector<double> const& angles, double epsilon = 0.0)
+	{
+		using namespace synthesis_cache_detail;
+		std::vector<uint64_t> payload(angles.size());
+		std::memcpy(payload.data(), angles.data(),
+		    angles.size() * sizeof(double));
+		return synthesize(circuit, qubits,
+		    make_key(Method::diagonal, qubits, epsilon, std::move(payload)),
+		    [&](Circuit& scratch, std::vector<WireRef> const& wires) {
+			    return tweedledum::diagonal_synth(
+			        scratch, wires, angles, epsilon);
+		    });
+	}
+
+	/*! \brief Cached `spectrum_synth`, see its documentation. */
+	double spectrum_synth(Circuit& circuit, std::vector<WireRef> const& qubits,
+	    TruthTable const& function, double epsilon = 0.0)
+	{
+		using namespace synthesis_cache_detail;
+		std::vector<uint64_t> payload(function.cbegin(), function.cend());
+		payload.push_back(function.num_vars());
+		return synthesize(circuit, qubits,
+		    make_key(Method::spectrum, qubits, epsilon, std::move(payload)),
+		    [&](Circuit& scratch, std::vector<WireRef> const& wires) {
+			    return tweedledum::spectrum_synth(
+			        scratch, wires, function, epsilon);
+		    });
+	}
+
+	uint32_t capacity() const
+	{
+		return cache_.capacity();
+	}
+
+	uint32_t size() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return cache_.size();
+	}
+
+	/*! \brief Returns the number of hits, misses and evictions so far. */
+	Stats stats() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return cache_.stats();
+	}
+
+	/*! \brief Removes all entries and resets the statistics. */
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		cache_.clear();
+	}
+
+private:
+	template<typename Fn>
+	double synthesize(Circuit& circuit, std::vector<WireRef> const& qubits,
+	    Key key, Fn&& fn)
+	{
+		using namespace synthesis_cache_detail;
+		std::shared_ptr<Entry const> entry;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (auto const* found = cache_.find(key)) {
+				entry = *found;
+			}
+		}
+		if (entry == nullptr) {
+			Circuit scratch("cache");
+			std::vector<WireRef> const wires = make_scratch(scratch, qubits);
+			double const error = fn(scratch, wires);
+			entry = std::make_shared<Entry const>(
+			    Entry{std::move(scratch), error});
+			std::lock_guard<std::mutex> lock(mutex_);
+			cache_.insert(std::move(key), entry);
+		}
+		replay(circuit, qubits, *entry);
+		return entry->error;
+	}
+
+	mutable std::mutex mutex_;
+	Cache cache_;
+};
+
+} // namespace tweedledum
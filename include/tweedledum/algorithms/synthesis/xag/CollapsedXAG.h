@@ -81,7 +81,7 @@ struct CollapsedXAG {
 	}
 };
 
-CollapsedXAG collapse_xag(mockturtle::xag_network const& xag)
+inline CollapsedXAG collapse_xag(mockturtle::xag_network const& xag)
 {
 	using XAG = mockturtle::xag_network;
 	using Node = typename XAG::node;
@@ -29,7 +29,7 @@ struct Step {
 	Step(Action a, uint32_t n) : action(a), node(n) {}
 };
 
-void pre_assign_qubits(CollapsedXAG& collapsed_xag,
+inline void pre_assign_qubits(CollapsedXAG& collapsed_xag,
     std::vector<WireRef> const& qubits, std::vector<WireRef>& to_qubit)
 {
 	uint32_t qubit_idx = 0;
@@ -54,7 +54,7 @@ void pre_assign_qubits(CollapsedXAG& collapsed_xag,
 	}
 }
 
-void post_assign_qubits(CollapsedXAG& collapsed_xag,
+inline void post_assign_qubits(CollapsedXAG& collapsed_xag,
     std::vector<WireRef> const& qubits,
     std::vector<WireRef>& to_qubit)
 {
@@ -100,7 +100,7 @@ void post_assign_qubits(CollapsedXAG& collapsed_xag,
 	}
 }
 
-void try_cleanup(CollapsedXAG& collapsed_xag,
+inline void try_cleanup(CollapsedXAG& collapsed_xag,
     std::vector<uint32_t> const& gates, std::vector<Step>& steps)
 {
 	for (uint32_t i_index : gates) {
@@ -115,7 +115,7 @@ void try_cleanup(CollapsedXAG& collapsed_xag,
 	}
 }
 
-void add_parity(Circuit& circuit, std::vector<WireRef> const& qubits)
+inline void add_parity(Circuit& circuit, std::vector<WireRef> const& qubits)
 {
 	if (qubits.size() == 1) {
 		return;
@@ -123,7 +123,7 @@ void add_parity(Circuit& circuit, std::vector<WireRef> const& qubits)
 	circuit.create_instruction(GateLib::Parity(), qubits);
 }
 
-void add_gate(Circuit& circuit, Gate const& gate,
+inline void add_gate(Circuit& circuit, Gate const& gate,
     std::vector<WireRef> const& to_qubit, WireRef target)
 {
 	std::vector<WireRef> in0;
@@ -161,7 +161,7 @@ void add_gate(Circuit& circuit, Gate const& gate,
 	add_parity(circuit, in0);
 }
 
-void execute_steps(std::vector<Step> const& steps,
+inline void execute_steps(std::vector<Step> const& steps,
     std::vector<Gate> const& gates, std::vector<WireRef>& to_qubit,
     Circuit& circuit)
 {
@@ -183,7 +183,7 @@ void execute_steps(std::vector<Step> const& steps,
 	}
 }
 
-void compute_outputs(CollapsedXAG& collapsed_xag, std::vector<WireRef> const& qubits, std::vector<WireRef> const& to_qubit,
+inline void compute_outputs(CollapsedXAG& collapsed_xag, std::vector<WireRef> const& qubits, std::vector<WireRef> const& to_qubit,
     Circuit& circuit)
 {
 	uint32_t qubit_idx = collapsed_xag.num_inputs;
@@ -232,7 +232,7 @@ void compute_outputs(CollapsedXAG& collapsed_xag, std::vector<WireRef> const& qu
 	}
 }
 
-void synthesize(Circuit& circuit, std::vector<WireRef> const& qubits,
+inline void synthesize(Circuit& circuit, std::vector<WireRef> const& qubits,
     mockturtle::xag_network const& xag)
 {
 	CollapsedXAG collapsed_xag = collapse_xag(xag);
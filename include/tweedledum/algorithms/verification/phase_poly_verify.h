@@ -0,0 +1,108 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../ir/Circuit.h"
+#include "../simulation/circuit_to_phase_poly.h"
+
+#include <cmath>
+#include <optional>
+
+namespace tweedledum {
+#pragma region Implementation details
+namespace phase_poly_verify_detail {
+
+// Maps an angle to [0, 2pi), snapping values within `atol` of 2pi to 0.
+inline double normalize(double const angle, double const atol)
+{
+	double const two_pi = 2 * M_PI;
+	double result = std::fmod(angle, two_pi);
+	if (result < 0) {
+		result += two_pi;
+	}
+	if (result > two_pi - atol) {
+		result = 0.0;
+	}
+	return result;
+}
+
+inline bool is_approx_equal(double const a, double const b, double const atol)
+{
+	double const diff = normalize(a - b, atol);
+	return diff <= atol;
+}
+
+} // namespace phase_poly_verify_detail
+#pragma endregion
+
+/*! \brief Checks whether two CNOT-dihedral circuits are equivalent.
+ *
+ * Both circuits are converted to their sum-over-paths form (see
+ * ``circuit_to_phase_poly``), which takes O(gates * n / 64) time, and then
+ * compared: the linear transformations and complemented outputs must be
+ * identical, and the phase polynomials must have the same terms with the same
+ * angles modulo 2pi.  Terms whose angle is a multiple of 2pi are ignored.
+ *
+ * Unlike ``unitary_verify``, this scales to hundreds of qubits.
+ *
+ * __NOTE__: Matching terms is sufficient but not necessary for the circuits to
+ * be equivalent: a few combinations of angles that are multiples of pi/4 give
+ * the same phase function with different terms (e.g., pi on x1, x2, and
+ * x1 + x2 is the identity).  Thus, a ``false`` result is only definitive when
+ * such special angles are not involved.
+ *
+ * \param[in] right A CNOT-dihedral circuit.
+ * \param[in] left A CNOT-dihedral circuit.
+ * \param[in] atol Absolute tolerance when comparing angles.
+ * \return ``true`` if equivalent (including the global phase), ``false`` if
+ * not, and ``std::nullopt`` if either circuit is not CNOT-dihedral.
+ */
+inline std::optional<bool> phase_poly_verify(
+    Circuit const& right, Circuit const& left, double const atol = 1e-08)
+{
+	using namespace phase_poly_verify_detail;
+	if (right.num_qubits() != left.num_qubits()) {
+		return false;
+	}
+	auto const right_form = circuit_to_phase_poly(right);
+	auto const left_form = circuit_to_phase_poly(left);
+	if (!right_form || !left_form) {
+		return std::nullopt;
+	}
+	if (right_form->linear_trans != left_form->linear_trans
+	    || right_form->complemented != left_form->complemented) {
+		return false;
+	}
+	if (!is_approx_equal(
+	        right_form->global_phase, left_form->global_phase, atol)) {
+		return false;
+	}
+	// The terms are kept sorted by parity, so we can compare them in a single
+	// pass while skipping the ones that have no effect.
+	auto r_it = right_form->terms.begin();
+	auto l_it = left_form->terms.begin();
+	auto const r_end = right_form->terms.end();
+	auto const l_end = left_form->terms.end();
+	while (true) {
+		while (r_it != r_end && normalize(r_it->second, atol) <= atol) {
+			++r_it;
+		}
+		while (l_it != l_end && normalize(l_it->second, atol) <= atol) {
+			++l_it;
+		}
+		if (r_it == r_end || l_it == l_end) {
+			break;
+		}
+		if (r_it->first != l_it->first
+		    || !is_approx_equal(r_it->second, l_it->second, atol)) {
+			return false;
+		}
+		++r_it;
+		++l_it;
+	}
+	return r_it == r_end && l_it == l_end;
+}
+
+} // namespace tweedledum
@@ -14,8 +14,18 @@
 
 namespace tweedledum {
 
+/*! \brief Checks whether two circuits implement the same unitary.
+ *
+ * \param[in] right A circuit.
+ * \param[in] left A circuit on the same qubits.
+ * \param[in] rtol Relative tolerance of each entry.
+ * \param[in] atol Absolute tolerance of each entry.
+ * \param[in] up_to_global_phase Whether the unitaries may differ by a global
+ * phase.
+ */
 inline bool unitary_verify(Circuit const& right, Circuit const& left,
-    double const rtol = 1e-05, double const atol = 1e-08)
+    double const rtol = 1e-05, double const atol = 1e-08,
+    bool const up_to_global_phase = false)
 {
 	Unitary u0("unitary_0");
 	std::for_each(right.begin_wire(), right.end_wire(),
@@ -36,7 +46,7 @@ inline bool unitary_verify(Circuit const& right, Circuit const& left,
 	[&](Instruction const& inst) {
 		u1.create_instruction(inst, {inst.begin(), inst.end()});
 	});
-	return is_approx_equal(u0, u1, rtol, atol);
+	return is_approx_equal(u0, u1, rtol, atol, up_to_global_phase);
 }
 
 } // namespace tweedledum
\ No newline at end of file
@@ -0,0 +1,105 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../ir/Circuit.h"
+#include "../../ir/Wire.h"
+#include "../simulation/simulate_classically.h"
+
+#include <cassert>
+#include <cstdint>
+#include <kitty/partial_truth_table.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief Random simulation screen of a circuit against an XAG.
+ *
+ * This is a cheap, incomplete, check meant to run before a formal one (e.g.,
+ * ``xag_verify``).  It draws ``64 * num_words`` random input patterns and
+ * simulates them through both the circuit (bit-parallel, 64 patterns per
+ * word) and the network (using ``kitty::partial_truth_table`` values).
+ *
+ * The parameter ``qubits`` follows the same convention as ``xag_synth``: the
+ * first ``xag.num_pis()`` qubits hold the inputs and the next
+ * ``xag.num_pos()`` qubits hold the outputs.  All other qubits (ancillae)
+ * are assumed to start in the 0 state.
+ *
+ * \param[in] circuit A classical reversible circuit.
+ * \param[in] qubits The qubits holding the inputs and outputs.
+ * \param[in] xag The reference network.
+ * \param[in] num_words Number of 64-pattern words to simulate.
+ * \param[in] seed Seed for the random patterns.
+ * \return The first input assignment, in the order of the primary inputs, for
+ * which the outputs differ, or ``std::nullopt`` if none was found.
+ */
+inline std::optional<std::vector<bool>> xag_random_verify(
+    Circuit const& circuit, std::vector<WireRef> const& qubits,
+    mockturtle::xag_network const& xag, uint32_t num_words = 64u,
+    uint64_t seed = 0u)
+{
+	using TruthTable = kitty::partial_truth_table;
+	uint32_t const num_inputs = xag.num_pis();
+	uint32_t const num_outputs = xag.num_pos();
+	assert(qubits.size() >= num_inputs + num_outputs);
+	assert(num_words > 0u);
+
+	// Networks without inputs have a single pattern to check.
+	if (num_inputs == 0u) {
+		num_words = 1u;
+	}
+	std::mt19937_64 gen(seed);
+	std::vector<TruthTable> patterns(num_inputs, TruthTable(num_words * 64u));
+	for (TruthTable& pattern : patterns) {
+		std::generate(pattern.begin(), pattern.end(), std::ref(gen));
+	}
+	std::vector<TruthTable> expected;
+	if (num_inputs == 0u) {
+		mockturtle::default_simulator<bool> sim(std::vector<bool>{});
+		for (bool value : mockturtle::simulate<bool>(xag, sim)) {
+			expected.emplace_back(64u);
+			if (value) {
+				expected.back() = ~expected.back();
+			}
+		}
+	} else {
+		mockturtle::partial_simulator sim(patterns);
+		expected = mockturtle::simulate<TruthTable>(xag, sim);
+	}
+
+	std::vector<uint64_t> words(circuit.num_qubits(), 0u);
+	for (uint32_t word = 0u; word < num_words; ++word) {
+		std::fill(words.begin(), words.end(), 0u);
+		for (uint32_t i = 0u; i < num_inputs; ++i) {
+			words.at(qubits[i].uid()) = *(patterns[i].cbegin() + word);
+		}
+		words = simulate_classically(circuit, std::move(words));
+		uint64_t mismatch = 0u;
+		for (uint32_t i = 0u; i < num_outputs; ++i) {
+			uint64_t const value = words[qubits[num_inputs + i].uid()];
+			mismatch |= value ^ *(expected[i].cbegin() + word);
+		}
+		if (num_inputs == 0u) {
+			mismatch &= 1u;
+		}
+		if (mismatch == 0u) {
+			continue;
+		}
+		uint32_t const lane = __builtin_ctzll(mismatch);
+		std::vector<bool> counter_example;
+		for (uint32_t i = 0u; i < num_inputs; ++i) {
+			uint64_t const value = *(patterns[i].cbegin() + word);
+			counter_example.push_back((value >> lane) & 1u);
+		}
+		return counter_example;
+	}
+	return std::nullopt;
+}
+
+} // namespace tweedledum
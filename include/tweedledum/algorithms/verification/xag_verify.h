@@ -0,0 +1,131 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../ir/Circuit.h"
+#include "../../ir/Wire.h"
+#include "../simulation/circuit_to_xag.h"
+#include "xag_random_verify.h"
+
+#include <bill/sat/interface/common.hpp>
+#include <bill/sat/interface/ghack.hpp>
+#include <bill/sat/interface/types.hpp>
+#include <cassert>
+#include <mockturtle/algorithms/cnf.hpp>
+#include <mockturtle/algorithms/miter.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <optional>
+#include <vector>
+
+// Formal equivalence checking of a classical circuit against the XAG it is
+// supposed to implement, e.g., the output of ``xag_synth``.
+//
+// Most buggy circuits are caught by a quick random simulation, which runs
+// first (see ``xag_random_verify``).  Otherwise, the circuit is symbolically
+// executed into an XAG (see ``circuit_to_xag``), and both networks are
+// combined into a miter, i.e., a single-output network which evaluates to 1
+// iff the outputs of the two networks differ for some input assignment.  The
+// miter is then encoded into CNF and handed to a SAT solver:  UNSAT means the
+// circuit is correct; SAT gives a counterexample.
+//
+// Unlike exhaustive simulation, this scales to XAGs with hundreds of inputs.
+//
+namespace tweedledum {
+
+/*! \brief Checks whether a circuit implements an XAG.
+ *
+ * The parameter ``qubits`` follows the same convention as ``xag_synth``: the
+ * first ``xag.num_pis()`` qubits hold the inputs and the next
+ * ``xag.num_pos()`` qubits hold the outputs.  All other qubits (ancillae)
+ * are assumed to start in the 0 state.
+ *
+ * \param[in] circuit A classical reversible circuit.
+ * \param[in] qubits The qubits holding the inputs and outputs.
+ * \param[in] xag The reference network.
+ * \param[out] counter_example (optional) If the result is ``false``, an input
+ * assignment for which the outputs differ, in the order of the primary inputs.
+ * \param[in] conflict_limit (optional) Resource limit for the SAT solver, 0
+ * means no limit.
+ * \return ``true`` if equivalent, ``false`` if not, and ``std::nullopt`` if
+ * the solver gave up because of the ``conflict_limit``.
+ */
+inline std::optional<bool> xag_verify(Circuit const& circuit,
+    std::vector<WireRef> const& qubits, mockturtle::xag_network const& xag,
+    std::vector<bool>* counter_example = nullptr, uint32_t conflict_limit = 0u)
+{
+	uint32_t const num_inputs = xag.num_pis();
+	uint32_t const num_outputs = xag.num_pos();
+	assert(qubits.size() >= num_inputs + num_outputs);
+	auto mismatch = xag_random_verify(circuit, qubits, xag, 16u);
+	if (mismatch) {
+		if (counter_example) {
+			*counter_example = std::move(*mismatch);
+		}
+		return false;
+	}
+
+	std::vector<WireRef> const inputs(
+	    qubits.begin(), qubits.begin() + num_inputs);
+	std::vector<WireRef> const outputs(qubits.begin() + num_inputs,
+	    qubits.begin() + num_inputs + num_outputs);
+
+	auto const extracted = circuit_to_xag(circuit, inputs, outputs);
+	auto const miter
+	    = *mockturtle::miter<mockturtle::xag_network>(xag, extracted);
+
+	bill::solver<bill::solvers::ghack> solver;
+	// Variable 0 is the constant, the next ones are the primary inputs and
+	// then one per gate, see ``mockturtle::node_literals``.
+	solver.add_variables(miter.num_pis() + miter.num_gates() + 1u);
+	auto const output = mockturtle::generate_cnf<mockturtle::xag_network,
+	    bill::lit_type>(miter, [&](std::vector<bill::lit_type> const& clause) {
+		solver.add_clause(clause);
+	})[0];
+
+	switch (solver.solve({output}, conflict_limit)) {
+	case bill::result::states::satisfiable:
+		if (counter_example) {
+			auto const model = solver.get_model().model();
+			counter_example->clear();
+			for (uint32_t i = 1u; i <= num_inputs; ++i) {
+				counter_example->push_back(
+				    model.at(i) == bill::lbool_type::true_);
+			}
+		}
+		return false;
+
+	case bill::result::states::unsatisfiable:
+		return true;
+
+	default:
+		return std::nullopt;
+	}
+}
+
+/*! \brief Checks whether a circuit implements an XAG.
+ *
+ * This is the variant for circuits synthesized with ``xag_synth(xag)``, in
+ * which the first qubits hold the inputs, followed by the outputs.
+ *
+ * \param[in] circuit A classical reversible circuit.
+ * \param[in] xag The reference network.
+ * \param[out] counter_example (optional) If the result is ``false``, an input
+ * assignment for which the outputs differ, in the order of the primary inputs.
+ * \return ``true`` if equivalent, ``false`` if not, and ``std::nullopt`` if
+ * the solver could not decide.
+ */
+inline std::optional<bool> xag_verify(Circuit const& circuit,
+    mockturtle::xag_network const& xag,
+    std::vector<bool>* counter_example = nullptr)
+{
+	std::vector<WireRef> qubits;
+	std::for_each(circuit.begin_wire(), circuit.end_wire(),
+	[&](Wire const& wire) {
+		qubits.push_back(circuit.wire_ref(wire));
+	});
+	return xag_verify(circuit, qubits, xag, counter_example);
+}
+
+} // namespace tweedledum
@@ -57,6 +57,11 @@ public:
 	    : angle_(angle)
 	{}
 
+	double angle() const
+	{
+		return angle_;
+	}
+
 	Matrix matrix() const
 	{
 		return {{{1., 0.}, {0., 0.}, {0., 0.}, std::exp(std::complex<double>(0., angle_))}};
@@ -8,6 +8,7 @@
 #include "Operator.h"
 #include "WireStorage.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <complex>
 #include <fmt/format.h>
@@ -168,8 +169,14 @@ private:
 
 		uint32_t const n_qubits = qubits.size();
 		uint32_t const k_end = (data_.size() >> n_qubits);
-		uint32_t const p0 = (1 << (n_qubits - 1)) - 1;
-		uint32_t const p1 = (1 << n_qubits) - 1;
+		// Negative controls must be 0 for the matrix to be applied
+		uint32_t p0 = 0u;
+		for (uint32_t i = 0u; i < controls.size(); ++i) {
+			if (controls.at(i).polarity() == WireRef::positive) {
+				p0 |= (1u << i);
+			}
+		}
+		uint32_t const p1 = p0 | (1u << (n_qubits - 1));
 		for (uint32_t k = 0u; k < k_end; ++k) {
 			std::vector<uint32_t> const idx
 			    = indicies(qubits, qubits_sorted, k);
@@ -184,7 +191,8 @@ private:
 	}
 
 	friend bool is_approx_equal(Unitary const& rhs, Unitary const& lhs,
-	    double const rtol, double const atol);
+	    double const rtol, double const atol,
+	    bool const up_to_global_phase);
 
 	friend void print(Unitary const& u, std::ostream& os, uint32_t indent,
 	    double const threshold);
@@ -197,19 +205,32 @@ private:
 
 // rtol : Relative tolerance
 // atol : Absolute tolerance
+// up_to_global_phase : Whether lhs may differ from rhs by a global phase
 inline bool is_approx_equal(Unitary const& rhs, Unitary const& lhs,
-    double const rtol = 1e-05, double const atol = 1e-08)
+    double const rtol = 1e-05, double const atol = 1e-08,
+    bool const up_to_global_phase = false)
 {
 	assert(rhs.data_.size() == lhs.data_.size());
 	uint32_t const end = rhs.data_.size();
+	// The phase is taken from the largest entry of lhs, which is at least
+	// 1/sqrt(rows) in magnitude, as its columns have unit norm.
+	std::complex<double> phase = 1.0;
+	if (up_to_global_phase) {
+		auto const by_abs = [](std::complex<double> const& a,
+		                        std::complex<double> const& b) {
+			return std::abs(a) < std::abs(b);
+		};
+		uint32_t const pivot = std::max_element(lhs.data_.begin(),
+		    lhs.data_.end(), by_abs) - lhs.data_.begin();
+		phase = rhs.data_.at(pivot) / lhs.data_.at(pivot);
+	}
 	bool is_close = true;
 	for (uint32_t i = 0u; i < end && is_close; ++i) {
-		is_close
-		    &= std::abs(rhs.data_.at(i).real() - lhs.data_.at(i).real())
-		       <= (atol + rtol * std::abs(lhs.data_.at(i).real()));
-		is_close
-		    &= std::abs(rhs.data_.at(i).imag() - lhs.data_.at(i).imag())
-		       <= (atol + rtol * std::abs(lhs.data_.at(i).imag()));
+		std::complex<double> const l = phase * lhs.data_.at(i);
+		is_close &= std::abs(rhs.data_.at(i).real() - l.real())
+		            <= (atol + rtol * std::abs(l.real()));
+		is_close &= std::abs(rhs.data_.at(i).imag() - l.imag())
+		            <= (atol + rtol * std::abs(l.imag()));
 	}
 	return is_close;
 }
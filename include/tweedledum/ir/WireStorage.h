@@ -39,6 +39,11 @@ public:
 		return wires_.cend();
 	}
 
+	WireRef wire_ref(Wire const& wire) const
+	{
+		return {wire.uid, wire.kind};
+	}
+
 protected:
 	WireRef do_create_qubit(std::string_view name)
 	{
@@ -0,0 +1,288 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "BitOps.h"
+#include "DynamicBitset.h"
+#include "Matrix.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <ostream>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief A dense matrix over GF(2).
+ *
+ * 2D, Row major.  Each row is packed into 64-bit words, so row operations,
+ * e.g., the XOR of two rows used to represent CNOT gates, work on 64 entries
+ * at a time and never allocate.  The unused bits at the end of each row are
+ * always zero.
+ */
+class BitMatrix {
+	using nested_list = std::initializer_list<std::initializer_list<uint8_t>>;
+
+public:
+	using word_type = uint64_t;
+	static constexpr uint32_t word_width = 64u;
+
+	static BitMatrix Identity(uint32_t size)
+	{
+		BitMatrix matrix(size, size);
+		for (uint32_t i = 0; i < size; ++i) {
+			matrix.set(i, i);
+		}
+		return matrix;
+	}
+
+	BitMatrix(uint32_t rows, uint32_t cols)
+	    : rows_(rows), cols_(cols),
+	      row_words_((cols + word_width - 1u) / word_width),
+	      data_(rows * row_words_, 0u)
+	{}
+
+	BitMatrix(nested_list lists)
+	    : BitMatrix(lists.size(), lists.size() ? lists.begin()->size() : 0)
+	{
+		uint32_t row = 0;
+		for (auto const& list : lists) {
+			uint32_t col = 0;
+			for (auto const& value : list) {
+				set(row, col, value & 1);
+				++col;
+			}
+			++row;
+		}
+	}
+
+	template<typename T>
+	explicit BitMatrix(Matrix<T> const& matrix)
+	    : BitMatrix(matrix.num_rows(), matrix.num_columns())
+	{
+		for (uint32_t i = 0u; i < rows_; ++i) {
+			for (uint32_t j = 0u; j < cols_; ++j) {
+				set(i, j, matrix(i, j) & 1);
+			}
+		}
+	}
+
+	uint32_t num_columns() const
+	{
+		return cols_;
+	}
+
+	uint32_t num_rows() const
+	{
+		return rows_;
+	}
+
+	// Number of words used to store each row.
+	uint32_t row_words() const
+	{
+		return row_words_;
+	}
+
+	word_type* row_data(uint32_t i)
+	{
+		assert(i < rows_);
+		return data_.data() + (i * row_words_);
+	}
+
+	word_type const* row_data(uint32_t i) const
+	{
+		assert(i < rows_);
+		return data_.data() + (i * row_words_);
+	}
+
+	bool operator()(uint32_t row, uint32_t column) const
+	{
+		assert(column < cols_);
+		return (row_data(row)[column / word_width] >> (column % word_width))
+		       & 1u;
+	}
+
+	void set(uint32_t row, uint32_t column, bool value = true)
+	{
+		assert(column < cols_);
+		word_type& word = row_data(row)[column / word_width];
+		word_type const mask = word_type(1) << (column % word_width);
+		word = value ? (word | mask) : (word & ~mask);
+	}
+
+	void flip(uint32_t row, uint32_t column)
+	{
+		assert(column < cols_);
+		row_data(row)[column / word_width]
+		    ^= word_type(1) << (column % word_width);
+	}
+
+	bool operator==(BitMatrix const& other) const
+	{
+		return rows_ == other.rows_ && cols_ == other.cols_
+		       && data_ == other.data_;
+	}
+
+	bool operator!=(BitMatrix const& other) const
+	{
+		return !(*this == other);
+	}
+
+	// row(dst) ^= row(src)
+	void row_xor(uint32_t dst, uint32_t src)
+	{
+		assert(dst != src);
+		words_xor(row_data(dst), row_data(src), row_words_);
+	}
+
+	void swap_rows(uint32_t i, uint32_t j)
+	{
+		std::swap_ranges(row_data(i), row_data(i) + row_words_, row_data(j));
+	}
+
+	// Number of ones in a row.
+	uint32_t row_weight(uint32_t i) const
+	{
+		return words_popcount(row_data(i), row_words_);
+	}
+
+	// Number of ones in a column.
+	uint32_t column_weight(uint32_t j) const
+	{
+		uint32_t weight = 0u;
+		for (uint32_t i = 0u; i < rows_; ++i) {
+			weight += (*this)(i, j);
+		}
+		return weight;
+	}
+
+	DynamicBitset<word_type> row(uint32_t i) const
+	{
+		DynamicBitset<word_type> result(cols_);
+		std::copy_n(row_data(i), row_words_, result.data());
+		return result;
+	}
+
+	DynamicBitset<word_type> column(uint32_t j) const
+	{
+		DynamicBitset<word_type> result(rows_);
+		for (uint32_t i = 0u; i < rows_; ++i) {
+			result.set(i, (*this)(i, j));
+		}
+		return result;
+	}
+
+private:
+	uint32_t rows_;
+	uint32_t cols_;
+	uint32_t row_words_;
+	std::vector<word_type> data_;
+};
+
+#pragma region Implementation details
+namespace bit_matrix_detail {
+
+// Transposes, in place, a 64 x 64 block stored as 64 words (one per row, bit
+// `j` of word `i` is entry (i, j)).  At each step, the off-diagonal quadrants
+// of every 2j x 2j sub-block are swapped, 64 entries at a time.
+inline void transpose_block(uint64_t* block)
+{
+	uint64_t mask = 0x00000000ffffffffull;
+	for (uint32_t j = 32u; j != 0u; j >>= 1, mask ^= (mask << j)) {
+		for (uint32_t k = 0u; k < 64u; k = ((k | j) + 1u) & ~j) {
+			uint64_t const t = ((block[k] >> j) ^ block[k | j]) & mask;
+			block[k] ^= (t << j);
+			block[k | j] ^= t;
+		}
+	}
+}
+
+// Copies the block made of the word `word` of rows [64 * row_block, ...) into
+// `block`.  Rows past the end of the matrix are read as zeros.
+inline void load_block(BitMatrix const& matrix, uint32_t row_block,
+    uint32_t word, uint64_t* block)
+{
+	uint32_t const begin = row_block * 64u;
+	uint32_t const end = std::min(begin + 64u, matrix.num_rows());
+	for (uint32_t i = begin; i < end; ++i) {
+		block[i - begin] = matrix.row_data(i)[word];
+	}
+	std::fill(block + (end - begin), block + 64u, 0u);
+}
+
+inline void store_block(BitMatrix& matrix, uint32_t row_block, uint32_t word,
+    uint64_t const* block)
+{
+	uint32_t const begin = row_block * 64u;
+	uint32_t const end = std::min(begin + 64u, matrix.num_rows());
+	for (uint32_t i = begin; i < end; ++i) {
+		matrix.row_data(i)[word] = block[i - begin];
+	}
+}
+
+} // namespace bit_matrix_detail
+#pragma endregion
+
+/*! \brief Transposes a bit matrix.
+ *
+ * The matrix is processed in 64 x 64 blocks, each of them transposed within
+ * registers, so that every word is read and written only once.
+ */
+inline BitMatrix transpose(BitMatrix const& matrix)
+{
+	using namespace bit_matrix_detail;
+	BitMatrix result(matrix.num_columns(), matrix.num_rows());
+	uint32_t const num_row_blocks = result.row_words();
+	uint64_t block[64];
+	for (uint32_t i = 0u; i < num_row_blocks; ++i) {
+		for (uint32_t j = 0u; j < matrix.row_words(); ++j) {
+			load_block(matrix, i, j, block);
+			transpose_block(block);
+			store_block(result, j, i, block);
+		}
+	}
+	return result;
+}
+
+/*! \brief Transposes a square bit matrix in place.
+ *
+ * Pairs of blocks that mirror each other across the diagonal are transposed
+ * and swapped, so no extra matrix is allocated.
+ */
+inline void transpose_inplace(BitMatrix& matrix)
+{
+	using namespace bit_matrix_detail;
+	assert(matrix.num_rows() == matrix.num_columns());
+	uint32_t const num_blocks = matrix.row_words();
+	uint64_t upper[64];
+	uint64_t lower[64];
+	for (uint32_t i = 0u; i < num_blocks; ++i) {
+		load_block(matrix, i, i, upper);
+		transpose_block(upper);
+		store_block(matrix, i, i, upper);
+		for (uint32_t j = i + 1u; j < num_blocks; ++j) {
+			load_block(matrix, i, j, upper);
+			load_block(matrix, j, i, lower);
+			transpose_block(upper);
+			transpose_block(lower);
+			store_block(matrix, j, i, upper);
+			store_block(matrix, i, j, lower);
+		}
+	}
+}
+
+inline void print(BitMatrix const& matrix, std::ostream& os)
+{
+	for (uint32_t i = 0u; i < matrix.num_rows(); ++i) {
+		for (uint32_t j = 0u; j < matrix.num_columns(); ++j) {
+			os << (matrix(i, j) ? "1 " : "0 ");
+		}
+		os << '\n';
+	}
+}
+
+} // namespace tweedledum
@@ -0,0 +1,393 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define TWEEDLEDUM_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Bulk operations on arrays of 64-bit words, the storage of bit-packed types
+// such as DynamicBitset<uint64_t> and BitMatrix rows.
+//
+// On x86-64, each operation has AVX2 and AVX-512 variants, compiled through
+// target attributes so that the library does not require any special flag.
+// The best variant supported by the running CPU is picked once, at first use,
+// and arrays too short to benefit from it take the scalar path.
+//
+namespace tweedledum {
+
+enum class SimdIsa : uint8_t {
+	scalar,
+	avx2,
+	avx512,
+};
+
+#pragma region Implementation details
+namespace bit_ops_detail {
+
+// Below this number of words the dispatch is not worth it.
+constexpr std::size_t min_simd_words = 8u;
+
+inline SimdIsa detect_isa()
+{
+#if defined(TWEEDLEDUM_X86_SIMD)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f")
+	    && __builtin_cpu_supports("avx512vpopcntdq")) {
+		return SimdIsa::avx512;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		return SimdIsa::avx2;
+	}
+#endif
+	return SimdIsa::scalar;
+}
+
+inline SimdIsa& active_isa()
+{
+	static SimdIsa isa = detect_isa();
+	return isa;
+}
+
+#pragma region Scalar
+inline void bit_xor_scalar(uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	for (std::size_t i = 0u; i < n; ++i) {
+		dst[i] ^= src[i];
+	}
+}
+
+inline void bit_and_scalar(uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	for (std::size_t i = 0u; i < n; ++i) {
+		dst[i] &= src[i];
+	}
+}
+
+inline void bit_or_scalar(uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	for (std::size_t i = 0u; i < n; ++i) {
+		dst[i] |= src[i];
+	}
+}
+
+inline std::size_t popcount_scalar(uint64_t const* words, std::size_t n)
+{
+	std::size_t count = 0u;
+	for (std::size_t i = 0u; i < n; ++i) {
+		count += __builtin_popcountll(words[i]);
+	}
+	return count;
+}
+
+inline bool any_scalar(uint64_t const* words, std::size_t n)
+{
+	uint64_t acc = 0u;
+	for (std::size_t i = 0u; i < n; ++i) {
+		acc |= words[i];
+	}
+	return acc != 0u;
+}
+
+inline bool all_scalar(uint64_t const* words, std::size_t n)
+{
+	uint64_t acc = ~uint64_t(0);
+	for (std::size_t i = 0u; i < n; ++i) {
+		acc &= words[i];
+	}
+	return acc == ~uint64_t(0);
+}
+#pragma endregion
+
+#if defined(TWEEDLEDUM_X86_SIMD)
+#pragma region AVX2
+#define TWEEDLEDUM_AVX2 __attribute__((target("avx2")))
+
+TWEEDLEDUM_AVX2 inline void bit_xor_avx2(
+    uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	std::size_t i = 0u;
+	for (; i + 4u <= n; i += 4u) {
+		__m256i const a = _mm256_loadu_si256((__m256i const*) (dst + i));
+		__m256i const b = _mm256_loadu_si256((__m256i const*) (src + i));
+		_mm256_storeu_si256((__m256i*) (dst + i), _mm256_xor_si256(a, b));
+	}
+	bit_xor_scalar(dst + i, src + i, n - i);
+}
+
+TWEEDLEDUM_AVX2 inline void bit_and_avx2(
+    uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	std::size_t i = 0u;
+	for (; i + 4u <= n; i += 4u) {
+		__m256i const a = _mm256_loadu_si256((__m256i const*) (dst + i));
+		__m256i const b = _mm256_loadu_si256((__m256i const*) (src + i));
+		_mm256_storeu_si256((__m256i*) (dst + i), _mm256_and_si256(a, b));
+	}
+	bit_and_scalar(dst + i, src + i, n - i);
+}
+
+TWEEDLEDUM_AVX2 inline void bit_or_avx2(
+    uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	std::size_t i = 0u;
+	for (; i + 4u <= n; i += 4u) {
+		__m256i const a = _mm256_loadu_si256((__m256i const*) (dst + i));
+		__m256i const b = _mm256_loadu_si256((__m256i const*) (src + i));
+		_mm256_storeu_si256((__m256i*) (dst + i), _mm256_or_si256(a, b));
+	}
+	bit_or_scalar(dst + i, src + i, n - i);
+}
+
+// Mula's method: nibble lookups with a byte shuffle, then horizontal sums of
+// the bytes of each 64-bit lane.
+TWEEDLEDUM_AVX2 inline std::size_t popcount_avx2(
+    uint64_t const* words, std::size_t n)
+{
+	__m256i const lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2,
+	    2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	__m256i const low_mask = _mm256_set1_epi8(0x0f);
+	__m256i acc = _mm256_setzero_si256();
+	std::size_t i = 0u;
+	for (; i + 4u <= n; i += 4u) {
+		__m256i const v
+		    = _mm256_loadu_si256((__m256i const*) (words + i));
+		__m256i const lo = _mm256_and_si256(v, low_mask);
+		__m256i const hi
+		    = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+		__m256i const counts
+		    = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+		        _mm256_shuffle_epi8(lookup, hi));
+		acc = _mm256_add_epi64(
+		    acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+	}
+	std::size_t count = _mm256_extract_epi64(acc, 0)
+	                    + _mm256_extract_epi64(acc, 1)
+	                    + _mm256_extract_epi64(acc, 2)
+	                    + _mm256_extract_epi64(acc, 3);
+	return count + popcount_scalar(words + i, n - i);
+}
+
+TWEEDLEDUM_AVX2 inline bool any_avx2(uint64_t const* words, std::size_t n)
+{
+	__m256i acc = _mm256_setzero_si256();
+	std::size_t i = 0u;
+	for (; i + 4u <= n; i += 4u) {
+		acc = _mm256_or_si256(
+		    acc, _mm256_loadu_si256((__m256i const*) (words + i)));
+	}
+	return !_mm256_testz_si256(acc, acc) || any_scalar(words + i, n - i);
+}
+
+TWEEDLEDUM_AVX2 inline bool all_avx2(uint64_t const* words, std::size_t n)
+{
+	__m256i const ones = _mm256_set1_epi64x(-1);
+	__m256i acc = ones;
+	std::size_t i = 0u;
+	for (; i + 4u <= n; i += 4u) {
+		acc = _mm256_and_si256(
+		    acc, _mm256_loadu_si256((__m256i const*) (words + i)));
+	}
+	return _mm256_testc_si256(acc, ones) && all_scalar(words + i, n - i);
+}
+
+#undef TWEEDLEDUM_AVX2
+#pragma endregion
+
+#pragma region AVX-512
+#define TWEEDLEDUM_AVX512 __attribute__((target("avx512f,avx512vpopcntdq")))
+
+TWEEDLEDUM_AVX512 inline void bit_xor_avx512(
+    uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	std::size_t i = 0u;
+	for (; i + 8u <= n; i += 8u) {
+		__m512i const a = _mm512_loadu_si512(dst + i);
+		__m512i const b = _mm512_loadu_si512(src + i);
+		_mm512_storeu_si512(dst + i, _mm512_xor_si512(a, b));
+	}
+	__mmask8 const tail = (1u << (n - i)) - 1u;
+	__m512i const a = _mm512_maskz_loadu_epi64(tail, dst + i);
+	__m512i const b = _mm512_maskz_loadu_epi64(tail, src + i);
+	_mm512_mask_storeu_epi64(dst + i, tail, _mm512_xor_si512(a, b));
+}
+
+TWEEDLEDUM_AVX512 inline void bit_and_avx512(
+    uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	std::size_t i = 0u;
+	for (; i + 8u <= n; i += 8u) {
+		__m512i const a = _mm512_loadu_si512(dst + i);
+		__m512i const b = _mm512_loadu_si512(src + i);
+		_mm512_storeu_si512(dst + i, _mm512_and_si512(a, b));
+	}
+	__mmask8 const tail = (1u << (n - i)) - 1u;
+	__m512i const a = _mm512_maskz_loadu_epi64(tail, dst + i);
+	__m512i const b = _mm512_maskz_loadu_epi64(tail, src + i);
+	_mm512_mask_storeu_epi64(dst + i, tail, _mm512_and_si512(a, b));
+}
+
+TWEEDLEDUM_AVX512 inline void bit_or_avx512(
+    uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	std::size_t i = 0u;
+	for (; i + 8u <= n; i += 8u) {
+		__m512i const a = _mm512_loadu_si512(dst + i);
+		__m512i const b = _mm512_loadu_si512(src + i);
+		_mm512_storeu_si512(dst + i, _mm512_or_si512(a, b));
+	}
+	__mmask8 const tail = (1u << (n - i)) - 1u;
+	__m512i const a = _mm512_maskz_loadu_epi64(tail, dst + i);
+	__m512i const b = _mm512_maskz_loadu_epi64(tail, src + i);
+	_mm512_mask_storeu_epi64(dst + i, tail, _mm512_or_si512(a, b));
+}
+
+TWEEDLEDUM_AVX512 inline std::size_t popcount_avx512(
+    uint64_t const* words, std::size_t n)
+{
+	__m512i acc = _mm512_setzero_si512();
+	std::size_t i = 0u;
+	for (; i + 8u <= n; i += 8u) {
+		__m512i const v = _mm512_loadu_si512(words + i);
+		acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+	}
+	__mmask8 const tail = (1u << (n - i)) - 1u;
+	__m512i const v = _mm512_maskz_loadu_epi64(tail, words + i);
+	acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+	// _mm512_reduce_add_epi64 makes GCC warn about an uninitialized
+	// variable in its own headers, so the lanes are summed by hand.
+	alignas(64) uint64_t lanes[8];
+	_mm512_store_si512(lanes, acc);
+	std::size_t count = 0u;
+	for (uint64_t lane : lanes) {
+		count += lane;
+	}
+	return count;
+}
+
+TWEEDLEDUM_AVX512 inline bool any_avx512(uint64_t const* words, std::size_t n)
+{
+	__m512i acc = _mm512_setzero_si512();
+	std::size_t i = 0u;
+	for (; i + 8u <= n; i += 8u) {
+		acc = _mm512_or_si512(acc, _mm512_loadu_si512(words + i));
+	}
+	__mmask8 const tail = (1u << (n - i)) - 1u;
+	acc = _mm512_or_si512(acc, _mm512_maskz_loadu_epi64(tail, words + i));
+	return _mm512_test_epi64_mask(acc, acc) != 0;
+}
+
+TWEEDLEDUM_AVX512 inline bool all_avx512(uint64_t const* words, std::size_t n)
+{
+	__m512i const ones = _mm512_set1_epi64(-1);
+	__m512i acc = ones;
+	std::size_t i = 0u;
+	for (; i + 8u <= n; i += 8u) {
+		acc = _mm512_and_si512(acc, _mm512_loadu_si512(words + i));
+	}
+	__mmask8 const tail = (1u << (n - i)) - 1u;
+	acc = _mm512_and_si512(
+	    acc, _mm512_mask_loadu_epi64(ones, tail, words + i));
+	return _mm512_cmpneq_epi64_mask(acc, ones) == 0;
+}
+
+#undef TWEEDLEDUM_AVX512
+#pragma endregion
+#endif
+
+} // namespace bit_ops_detail
+#pragma endregion
+
+/*! \brief Returns the best instruction set supported by the running CPU. */
+inline SimdIsa simd_isa_supported()
+{
+	static SimdIsa const isa = bit_ops_detail::detect_isa();
+	return isa;
+}
+
+/*! \brief Returns the instruction set used by the bulk operations. */
+inline SimdIsa simd_isa()
+{
+	return bit_ops_detail::active_isa();
+}
+
+/*! \brief Selects the instruction set used by the bulk operations.
+ *
+ * This is meant for testing and benchmarking.  Requests for an instruction set
+ * the CPU does not support fall back to the best supported one.  Not thread
+ * safe: no bulk operation may run concurrently.
+ */
+inline void set_simd_isa(SimdIsa isa)
+{
+	if (isa > simd_isa_supported()) {
+		isa = simd_isa_supported();
+	}
+	bit_ops_detail::active_isa() = isa;
+}
+
+#if defined(TWEEDLEDUM_X86_SIMD)
+#define TWEEDLEDUM_DISPATCH(name, n, ...)                                      \
+	do {                                                                   \
+		using namespace bit_ops_detail;                                \
+		if ((n) >= min_simd_words) {                                   \
+			switch (active_isa()) {                                \
+			case SimdIsa::avx512:                                  \
+				return name##_avx512(__VA_ARGS__);             \
+			case SimdIsa::avx2:                                    \
+				return name##_avx2(__VA_ARGS__);               \
+			default:                                               \
+				break;                                         \
+			}                                                      \
+		}                                                              \
+		return name##_scalar(__VA_ARGS__);                             \
+	} while (0)
+#else
+#define TWEEDLEDUM_DISPATCH(name, n, ...)                                      \
+	return bit_ops_detail::name##_scalar(__VA_ARGS__)
+#endif
+
+/*! \brief dst[i] ^= src[i], for i in [0, n). */
+inline void words_xor(uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	TWEEDLEDUM_DISPATCH(bit_xor, n, dst, src, n);
+}
+
+/*! \brief dst[i] &= src[i], for i in [0, n). */
+inline void words_and(uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	TWEEDLEDUM_DISPATCH(bit_and, n, dst, src, n);
+}
+
+/*! \brief dst[i] |= src[i], for i in [0, n). */
+inline void words_or(uint64_t* dst, uint64_t const* src, std::size_t n)
+{
+	TWEEDLEDUM_DISPATCH(bit_or, n, dst, src, n);
+}
+
+/*! \brief Number of set bits in words [0, n). */
+inline std::size_t words_popcount(uint64_t const* words, std::size_t n)
+{
+	TWEEDLEDUM_DISPATCH(popcount, n, words, n);
+}
+
+/*! \brief Whether any bit is set in words [0, n). */
+inline bool words_any(uint64_t const* words, std::size_t n)
+{
+	TWEEDLEDUM_DISPATCH(any, n, words, n);
+}
+
+/*! \brief Whether all bits are set in words [0, n). */
+inline bool words_all(uint64_t const* words, std::size_t n)
+{
+	TWEEDLEDUM_DISPATCH(all, n, words, n);
+}
+
+#undef TWEEDLEDUM_DISPATCH
+
+} // namespace tweedledum
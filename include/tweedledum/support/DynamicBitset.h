@@ -4,7 +4,16 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 
+#include "BitOps.h"
+#include "SmallVector.h"
+
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace tweedledum {
 
@@ -17,14 +26,18 @@ namespace tweedledum {
  * construction of a DynamicBitset object.
  *
  * TODO: implement methods to grow it dynamically
- * TODO: implement operator<< and operator>>
  * FIXME: possibly use a library for this?
  * */
 template<class WordType = uint32_t>
 class DynamicBitset {
 	static_assert(std::is_unsigned<WordType>::value,
 	    "WordType is not an unsigned integral type");
-	using container_type = std::vector<WordType>;
+	// Bitsets of up to 128 bits, e.g., the states of small circuits, are
+	// stored inline and never touch the allocator.
+	using container_type = SmallVector<WordType,
+	    128 / std::numeric_limits<WordType>::digits>;
+	// Bitsets of 64-bit words use the (SIMD) bulk operations of BitOps.h
+	static constexpr bool is_word_blocked = std::is_same_v<WordType, uint64_t>;
 
 public:
 	using block_type = WordType;
@@ -221,6 +234,21 @@ public:
 		assert((other.bits_ = container_type()).empty());
 		other.num_bits_ = 0;
 	}
+
+	DynamicBitset& operator=(DynamicBitset const& other)
+	{
+		num_bits_ = other.num_bits_;
+		bits_ = other.bits_;
+		return *this;
+	}
+
+	DynamicBitset& operator=(DynamicBitset&& other)
+	{
+		num_bits_ = std::exchange(other.num_bits_, 0);
+		bits_ = std::move(other.bits_);
+		other.bits_.clear();
+		return *this;
+	}
 #pragma endregion
 
 #pragma region Comparison
@@ -233,12 +261,25 @@ public:
 	{
 		return !(*this == rhs);
 	}
+
+	// Compares the bitsets as if they were unsigned integers, which makes it
+	// possible to keep them sorted, e.g., as parity terms in a LinearPP.
+	bool operator<(DynamicBitset const& rhs) const noexcept
+	{
+		assert(size() == rhs.size());
+		return std::lexicographical_compare(bits_.rbegin(), bits_.rend(),
+		    rhs.bits_.rbegin(), rhs.bits_.rend());
+	}
 #pragma endregion
 
 #pragma region Dynamic bitset operations
 	DynamicBitset& operator&=(const DynamicBitset& rhs) noexcept
 	{
 		assert(size() == rhs.size());
+		if constexpr (is_word_blocked) {
+			words_and(bits_.data(), rhs.bits_.data(), num_blocks());
+			return *this;
+		}
 		for (size_type i = 0; i < num_blocks(); ++i) {
 			bits_[i] &= rhs.bits_[i];
 		}
@@ -248,6 +289,10 @@ public:
 	DynamicBitset& operator|=(const DynamicBitset& rhs) noexcept
 	{
 		assert(size() == rhs.size());
+		if constexpr (is_word_blocked) {
+			words_or(bits_.data(), rhs.bits_.data(), num_blocks());
+			return *this;
+		}
 		for (size_type i = 0; i < num_blocks(); ++i) {
 			bits_[i] |= rhs.bits_[i];
 		}
@@ -257,15 +302,93 @@ public:
 	DynamicBitset& operator^=(const DynamicBitset& rhs) noexcept
 	{
 		assert(size() == rhs.size());
+		if constexpr (is_word_blocked) {
+			words_xor(bits_.data(), rhs.bits_.data(), num_blocks());
+			return *this;
+		}
 		for (size_type i = 0; i < this->num_blocks(); ++i) {
 			bits_[i] ^= rhs.bits_[i];
 		}
 		return *this;
 	}
 
-	// TODO
-	DynamicBitset& operator<<=(size_type position) noexcept;
-	DynamicBitset& operator>>=(size_type position) noexcept;
+	// Shifts towards higher positions, i.e., bit `i` moves to `i + shift`.
+	// Bits shifted past the end are lost and the vacated ones become 0.
+	DynamicBitset& operator<<=(size_type shift) noexcept
+	{
+		if (shift >= num_bits_) {
+			return reset();
+		}
+		size_type const word_shift = shift / block_width;
+		block_width_type const bit_shift = shift % block_width;
+		size_type const n = num_blocks();
+		for (size_type i = n; i-- > word_shift;) {
+			block_type block = bits_[i - word_shift] << bit_shift;
+			if (bit_shift && i > word_shift) {
+				block |= bits_[i - word_shift - 1]
+				         >> (block_width - bit_shift);
+			}
+			bits_[i] = block;
+		}
+		std::fill_n(bits_.begin(), word_shift, block_type(0));
+		zero_unused_bits();
+		return *this;
+	}
+
+	// Shifts towards lower positions, i.e., bit `i` moves to `i - shift`.
+	DynamicBitset& operator>>=(size_type shift) noexcept
+	{
+		if (shift >= num_bits_) {
+			return reset();
+		}
+		size_type const word_shift = shift / block_width;
+		block_width_type const bit_shift = shift % block_width;
+		size_type const n = num_blocks();
+		for (size_type i = 0; i + word_shift < n; ++i) {
+			block_type block = bits_[i + word_shift] >> bit_shift;
+			if (bit_shift && i + word_shift + 1 < n) {
+				block |= bits_[i + word_shift + 1]
+				         << (block_width - bit_shift);
+			}
+			bits_[i] = block;
+		}
+		std::fill(bits_.end() - word_shift, bits_.end(), block_type(0));
+		return *this;
+	}
+
+	DynamicBitset operator<<(size_type shift) const noexcept
+	{
+		DynamicBitset result(*this);
+		result <<= shift;
+		return result;
+	}
+
+	DynamicBitset operator>>(size_type shift) const noexcept
+	{
+		DynamicBitset result(*this);
+		result >>= shift;
+		return result;
+	}
+
+	// Rotates towards higher positions: bit `i` moves to `(i + shift) % size`
+	DynamicBitset& rotate_left(size_type shift) noexcept
+	{
+		if (empty() || (shift %= num_bits_) == 0) {
+			return *this;
+		}
+		DynamicBitset wrapped = *this >> (num_bits_ - shift);
+		*this <<= shift;
+		return *this |= wrapped;
+	}
+
+	// Rotates towards lower positions: bit `i` moves to `(i - shift) % size`
+	DynamicBitset& rotate_right(size_type shift) noexcept
+	{
+		if (empty()) {
+			return *this;
+		}
+		return rotate_left(num_bits_ - (shift % num_bits_));
+	}
 #pragma endregion
 
 #pragma region Bit operations
@@ -365,10 +488,16 @@ public:
 		const auto extra_bits = bit_index(size());
 		auto const all_ones = static_cast<block_type>(~0);
 
-		for (size_type i = 0, e = num_blocks() - 1; i < e; ++i) {
-			if (bits_[i] != all_ones) {
+		if constexpr (is_word_blocked) {
+			if (!words_all(bits_.data(), num_blocks() - 1)) {
 				return false;
 			}
+		} else {
+			for (size_type i = 0, e = num_blocks() - 1; i < e; ++i) {
+				if (bits_[i] != all_ones) {
+					return false;
+				}
+			}
 		}
 		if (extra_bits == 0) {
 			return bits_.back() == all_ones;
@@ -384,6 +513,9 @@ public:
 
 	bool any() const noexcept
 	{
+		if constexpr (is_word_blocked) {
+			return words_any(bits_.data(), num_blocks());
+		}
 		for (auto block : bits_) {
 			if (block) {
 				return true;
@@ -399,12 +531,52 @@ public:
 
 	size_type count() const noexcept
 	{
+		if constexpr (is_word_blocked) {
+			return words_popcount(bits_.data(), num_blocks());
+		}
 		size_type count = 0;
 		for (auto block : bits_) {
-			count += __builtin_popcount(block);
+			count += popcount(block);
 		}
 		return count;
 	}
+
+	// Returns the position of the lowest set bit, or `npos` if none.
+	size_type find_first() const noexcept
+	{
+		return find_from_block(0);
+	}
+
+	// Returns the position of the lowest set bit after `position`, or `npos`
+	// if none.
+	size_type find_next(size_type position) const noexcept
+	{
+		if (position == npos || ++position >= num_bits_) {
+			return npos;
+		}
+		size_type const index = block_index(position);
+		block_type const block
+		    = bits_[index]
+		      & (static_cast<block_type>(~block_type(0))
+		          << bit_index(position));
+		if (block) {
+			return index * block_width + count_trailing_zeros(block);
+		}
+		return find_from_block(index + 1);
+	}
+
+	// Calls `fn(position)` for each set bit, in increasing order.  This
+	// takes time proportional to the number of blocks plus set bits.
+	template<typename Fn>
+	void foreach_set_bit(Fn&& fn) const
+	{
+		for (size_type i = 0; i < num_blocks(); ++i) {
+			for (block_type block = bits_[i]; block;
+			     block &= (block - 1)) {
+				fn(i * block_width + count_trailing_zeros(block));
+			}
+		}
+	}
 #pragma endregion
 
 #pragma region Iterators
@@ -436,11 +608,49 @@ public:
 	}
 #pragma endregion
 
-	// TODO
-	DynamicBitset operator<<(size_type position) const noexcept;
-	DynamicBitset operator>>(size_type position) const noexcept;
+#pragma region Raw access
+	block_type* data() noexcept
+	{
+		return bits_.data();
+	}
+
+	block_type const* data() const noexcept
+	{
+		return bits_.data();
+	}
+#pragma endregion
 
 private:
+	static size_type popcount(block_type block) noexcept
+	{
+		if constexpr (block_width <= 32) {
+			return __builtin_popcount(block);
+		} else {
+			return __builtin_popcountll(block);
+		}
+	}
+
+	static size_type count_trailing_zeros(block_type block) noexcept
+	{
+		assert(block != 0);
+		if constexpr (block_width <= 32) {
+			return __builtin_ctz(block);
+		} else {
+			return __builtin_ctzll(block);
+		}
+	}
+
+	size_type find_from_block(size_type index) const noexcept
+	{
+		for (; index < num_blocks(); ++index) {
+			if (bits_[index]) {
+				return index * block_width
+				       + count_trailing_zeros(bits_[index]);
+			}
+		}
+		return npos;
+	}
+
 	constexpr size_type block_index(size_type position) const noexcept
 	{
 		return position / block_width;
@@ -497,8 +707,28 @@ private:
 		}
 	}
 
-	size_type num_bits_;
+	size_type num_bits_ = 0;
 	container_type bits_;
 };
 
 } // namespace tweedledum
+
+namespace std {
+
+template<class WordType>
+struct hash<tweedledum::DynamicBitset<WordType>> {
+	std::size_t operator()(
+	    tweedledum::DynamicBitset<WordType> const& bitset) const noexcept
+	{
+		// Combine the blocks as in boost::hash_combine
+		std::size_t seed = bitset.size();
+		WordType const* blocks = bitset.data();
+		for (std::size_t i = 0u; i < bitset.num_blocks(); ++i) {
+			seed ^= std::hash<WordType>()(blocks[i]) + 0x9e3779b9
+			        + (seed << 6) + (seed >> 2);
+		}
+		return seed;
+	}
+};
+
+} // namespace std
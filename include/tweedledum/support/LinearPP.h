@@ -4,14 +4,30 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
 #include <fmt/format.h>
+#include <limits>
 #include <ostream>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <valarray>
+#include <vector>
 
 namespace tweedledum {
 
 // Linear Phase Polynomial (LinerPP)
+//
+// The terms are kept in a vector.  Accumulating and extracting terms goes
+// through a hash index from parity to position, so both take O(1) (expected)
+// time.  The index is only built when one of these operations needs it, and
+// `finalize()` drops it, so a polynomial built with `append_term` or already
+// finalized takes no more memory than its terms.  Terms are iterated in the
+// order they were first added, which extractions may shuffle.  Call
+// `finalize()` to sort them by parity, which requires `Parity` to define
+// `operator<`.
 template<typename Parity = uint32_t>
 class LinearPP {
 	using Angle = double;
@@ -33,52 +49,118 @@ public:
 		return terms_.cend();
 	}
 
+	// Whether the hash index is currently built.
+	bool indexed() const
+	{
+		return indexed_;
+	}
+
+	void reserve(uint32_t num_terms)
+	{
+		terms_.reserve(num_terms);
+	}
+
 	void add_term(Parity const& parity, Angle const& angle)
 	{
-		auto it = lower_bound(terms_.begin(), terms_.end(), parity);
-		if (it != terms_.end() && it->first == parity) {
-			it->second += angle;
+		build_index();
+		auto const [it, inserted] = index_.emplace(parity, terms_.size());
+		if (!inserted) {
+			terms_[it->second].second += angle;
 			return;
 		}
-		terms_.emplace(it, parity, angle);
+		terms_.emplace_back(parity, angle);
+	}
+
+	// Adds a term whose parity is not in the polynomial yet.  Unlike
+	// `add_term`, this does not need the index, so it is the cheapest way
+	// to build polynomials with distinct parities, e.g., dense spectra.
+	void append_term(Parity const& parity, Angle const& angle)
+	{
+		if (indexed_) {
+			assert(index_.count(parity) == 0u);
+			index_.emplace(parity, terms_.size());
+		}
+		terms_.emplace_back(parity, angle);
 	}
 
 	Angle extract_term(Parity const& parity)
 	{
-		auto it = lower_bound(terms_.begin(), terms_.end(), parity);
-		if (it == terms_.end() || it->first != parity) {
+		build_index();
+		auto it = index_.find(parity);
+		if (it == index_.end()) {
 			return 0;
 		}
-		Angle const angle = it->second;
-		terms_.erase(it);
+		uint32_t const position = it->second;
+		Angle const angle = terms_[position].second;
+		index_.erase(it);
+		// Fill the gap with the last term
+		if (position + 1 != terms_.size()) {
+			terms_[position] = std::move(terms_.back());
+			index_[terms_[position].first] = position;
+		}
+		terms_.pop_back();
 		return angle;
 	}
 
-private:
-	using Iterator = typename std::vector<LinearTerm>::iterator;
-	using DistType = typename std::iterator_traits<Iterator>::difference_type;
+	// Sorts the terms by parity and drops the index.
+	void finalize()
+	{
+		std::unordered_map<Parity, uint32_t>().swap(index_);
+		indexed_ = false;
+		auto const by_parity = [](LinearTerm const& a, LinearTerm const& b) {
+			return a.first < b.first;
+		};
+		if (!std::is_sorted(terms_.begin(), terms_.end(), by_parity)) {
+			std::sort(terms_.begin(), terms_.end(), by_parity);
+		}
+	}
 
-	Iterator lower_bound(Iterator first, Iterator last, Parity const& parity)
+private:
+	void build_index()
 	{
-		DistType len = std::distance(first, last);
-		while (len > 0) {
-			if (first->first == parity) {
-				break;
-			}
-			DistType half = len >> 1;
-			Iterator middle = first;
-			std::advance(middle, half);
-			if (middle->first < parity) {
-				first = ++middle;
-				len -= half + 1;
-			} else {
-				len = half;
-			}
+		if (indexed_) {
+			return;
+		}
+		index_.reserve(terms_.size());
+		for (uint32_t i = 0u; i < terms_.size(); ++i) {
+			index_.emplace(terms_[i].first, i);
 		}
-		return first;
+		indexed_ = true;
 	}
 
 	std::vector<LinearTerm> terms_;
+	std::unordered_map<Parity, uint32_t> index_;
+	bool indexed_ = false;
 };
 
+// Parities are bit strings over the variables, either an unsigned integer
+// (limited to its width) or a DynamicBitset (any width).  These helpers give
+// synthesis algorithms a common way to handle both.
+
+/*! \brief Returns the parity of just the variable `i` out of `num_vars`. */
+template<typename Parity>
+inline Parity parity_var(uint32_t num_vars, uint32_t i)
+{
+	if constexpr (std::is_integral_v<Parity>) {
+		assert(num_vars <= std::numeric_limits<Parity>::digits);
+		(void) num_vars;
+		return Parity(1) << i;
+	} else {
+		Parity parity(num_vars);
+		parity.set(i);
+		return parity;
+	}
+}
+
+/*! \brief Whether the variable `i` is part of the parity. */
+template<typename Parity>
+inline bool parity_has_var(Parity const& parity, uint32_t i)
+{
+	if constexpr (std::is_integral_v<Parity>) {
+		return (parity >> i) & 1;
+	} else {
+		return parity[i];
+	}
+}
+
 } // namespace tweedledum
@@ -0,0 +1,114 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace tweedledum {
+
+/*! \brief A size-bounded map which evicts the least recently used entry.
+ *
+ * Lookups and insertions take constant expected time.  The whole key is stored
+ * and compared, so hash collisions never lead to a wrong value.  The cache
+ * keeps count of hits, misses and evictions.  It is not thread-safe.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+	struct Stats {
+		uint64_t hits = 0u;
+		uint64_t misses = 0u;
+		uint64_t evictions = 0u;
+	};
+
+	/*! \brief Creates a cache holding at most `capacity` entries.
+	 *
+	 * A cache of capacity zero stores nothing, so every lookup misses.
+	 */
+	LruCache(uint32_t capacity) : capacity_(capacity)
+	{}
+
+	uint32_t capacity() const
+	{
+		return capacity_;
+	}
+
+	uint32_t size() const
+	{
+		return index_.size();
+	}
+
+	Stats const& stats() const
+	{
+		return stats_;
+	}
+
+	/*! \brief Returns the value stored for `key`, or nullptr on a miss.
+	 *
+	 * A hit makes the entry the most recently used one.  The pointer remains
+	 * valid until the entry is evicted.
+	 */
+	Value const* find(Key const& key)
+	{
+		auto const it = index_.find(key);
+		if (it == index_.end()) {
+			++stats_.misses;
+			return nullptr;
+		}
+		++stats_.hits;
+		order_.splice(order_.begin(), order_, it->second.second);
+		return &it->second.first;
+	}
+
+	/*! \brief Stores `value` for `key`, evicting the least recently used
+	 * entry if the cache is full.
+	 */
+	void insert(Key key, Value value)
+	{
+		if (capacity_ == 0u) {
+			return;
+		}
+		auto const it = index_.find(key);
+		if (it != index_.end()) {
+			it->second.first = std::move(value);
+			order_.splice(order_.begin(), order_, it->second.second);
+			return;
+		}
+		if (index_.size() == capacity_) {
+			index_.erase(index_.find(*order_.back()));
+			order_.pop_back();
+			++stats_.evictions;
+		}
+		auto const inserted = index_.emplace(std::move(key),
+		    std::make_pair(std::move(value), order_.end()));
+		order_.push_front(&inserted.first->first);
+		inserted.first->second.second = order_.begin();
+	}
+
+	/*! \brief Removes all entries and resets the statistics. */
+	void clear()
+	{
+		index_.clear();
+		order_.clear();
+		stats_ = Stats();
+	}
+
+private:
+	// The recency list points to the keys owned by the map, whose nodes
+	// never move, so each key is stored once.
+	using Order = std::list<Key const*>;
+
+	uint32_t capacity_;
+	Order order_;
+	std::unordered_map<Key, std::pair<Value, typename Order::iterator>, Hash>
+	    index_;
+	Stats stats_;
+};
+
+} // namespace tweedledum
@@ -0,0 +1,247 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace tweedledum {
+
+/*! \brief A vector which stores up to `N` elements inline.
+ *
+ * Only heap-allocates once it grows beyond `N` elements, which makes small
+ * instances cheap to create, copy and destroy, e.g., the blocks of bitsets
+ * that are copied in tight loops.  It only implements the subset of the
+ * ``std::vector`` interface needed in this library, and only for trivially
+ * copyable element types.
+ */
+template<typename T, uint32_t N>
+class SmallVector {
+	static_assert(std::is_trivially_copyable_v<T>,
+	    "SmallVector requires a trivially copyable type");
+	static_assert(N > 0u, "SmallVector requires some inline storage");
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using iterator = T*;
+	using const_iterator = T const*;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+#pragma region Constructors
+	SmallVector() noexcept : data_(inline_), size_(0u), capacity_(N) {}
+
+	SmallVector(size_type size, T const& value = T()) : SmallVector()
+	{
+		resize(size, value);
+	}
+
+	SmallVector(SmallVector const& other) : SmallVector()
+	{
+		*this = other;
+	}
+
+	SmallVector(SmallVector&& other) noexcept : SmallVector()
+	{
+		*this = std::move(other);
+	}
+
+	~SmallVector()
+	{
+		if (!is_inline()) {
+			delete[] data_;
+		}
+	}
+
+	SmallVector& operator=(SmallVector const& other)
+	{
+		if (this != &other) {
+			size_ = 0u;
+			reserve(other.size_);
+			std::copy_n(other.data_, other.size_, data_);
+			size_ = other.size_;
+		}
+		return *this;
+	}
+
+	SmallVector& operator=(SmallVector&& other) noexcept
+	{
+		if (this == &other) {
+			return *this;
+		}
+		if (other.is_inline()) {
+			// Fits in our own storage, whether inline or not.
+			std::copy_n(other.data_, other.size_, data_);
+			size_ = other.size_;
+		} else {
+			if (!is_inline()) {
+				delete[] data_;
+			}
+			data_ = other.data_;
+			size_ = other.size_;
+			capacity_ = other.capacity_;
+			other.data_ = other.inline_;
+			other.capacity_ = N;
+		}
+		other.size_ = 0u;
+		return *this;
+	}
+#pragma endregion
+
+#pragma region Comparison
+	bool operator==(SmallVector const& other) const noexcept
+	{
+		return std::equal(begin(), end(), other.begin(), other.end());
+	}
+
+	bool operator!=(SmallVector const& other) const noexcept
+	{
+		return !(*this == other);
+	}
+#pragma endregion
+
+#pragma region Element access
+	T& operator[](size_type i) noexcept
+	{
+		assert(i < size_);
+		return data_[i];
+	}
+
+	T const& operator[](size_type i) const noexcept
+	{
+		assert(i < size_);
+		return data_[i];
+	}
+
+	T& back() noexcept
+	{
+		assert(size_ > 0u);
+		return data_[size_ - 1u];
+	}
+
+	T const& back() const noexcept
+	{
+		assert(size_ > 0u);
+		return data_[size_ - 1u];
+	}
+
+	T* data() noexcept
+	{
+		return data_;
+	}
+
+	T const* data() const noexcept
+	{
+		return data_;
+	}
+#pragma endregion
+
+#pragma region Iterators
+	iterator begin() noexcept
+	{
+		return data_;
+	}
+
+	const_iterator begin() const noexcept
+	{
+		return data_;
+	}
+
+	iterator end() noexcept
+	{
+		return data_ + size_;
+	}
+
+	const_iterator end() const noexcept
+	{
+		return data_ + size_;
+	}
+
+	reverse_iterator rbegin() noexcept
+	{
+		return reverse_iterator(end());
+	}
+
+	const_reverse_iterator rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	reverse_iterator rend() noexcept
+	{
+		return reverse_iterator(begin());
+	}
+
+	const_reverse_iterator rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+#pragma endregion
+
+#pragma region Capacity
+	size_type size() const noexcept
+	{
+		return size_;
+	}
+
+	bool empty() const noexcept
+	{
+		return size_ == 0u;
+	}
+
+	size_type capacity() const noexcept
+	{
+		return capacity_;
+	}
+
+	bool is_inline() const noexcept
+	{
+		return data_ == inline_;
+	}
+#pragma endregion
+
+#pragma region Modifiers
+	void reserve(size_type capacity)
+	{
+		if (capacity <= capacity_) {
+			return;
+		}
+		T* data = new T[capacity];
+		std::copy_n(data_, size_, data);
+		if (!is_inline()) {
+			delete[] data_;
+		}
+		data_ = data;
+		capacity_ = capacity;
+	}
+
+	void resize(size_type size, T const& value = T())
+	{
+		reserve(size);
+		if (size > size_) {
+			std::fill(data_ + size_, data_ + size, value);
+		}
+		size_ = size;
+	}
+
+	void clear() noexcept
+	{
+		size_ = 0u;
+	}
+#pragma endregion
+
+private:
+	T* data_;
+	size_type size_;
+	size_type capacity_;
+	T inline_[N];
+};
+
+} // namespace tweedledum
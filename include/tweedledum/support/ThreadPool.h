@@ -0,0 +1,141 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief A minimal pool of worker threads.
+ *
+ * The pool is meant to run embarrassingly parallel loops, e.g., simulating
+ * disjoint chunks of an input space or trying several synthesis configurations
+ * at once.  The thread calling ``parallel_for`` also takes part in the work,
+ * so a pool of ``N`` threads spawns only ``N - 1`` workers.  A pool of one
+ * thread runs everything inline.
+ *
+ * Calling ``parallel_for`` from within a task is allowed: the caller will
+ * simply process the remaining tasks itself if all workers are busy.
+ */
+class ThreadPool {
+public:
+	ThreadPool(uint32_t num_threads = 0u) : stop_(false)
+	{
+		if (num_threads == 0u) {
+			num_threads = std::thread::hardware_concurrency();
+		}
+		num_threads = std::max(num_threads, 1u);
+		workers_.reserve(num_threads - 1u);
+		for (uint32_t i = 1u; i < num_threads; ++i) {
+			workers_.emplace_back([this]() { worker_loop(); });
+		}
+	}
+
+	ThreadPool(ThreadPool const&) = delete;
+	ThreadPool& operator=(ThreadPool const&) = delete;
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			stop_ = true;
+		}
+		condition_.notify_all();
+		for (std::thread& worker : workers_) {
+			worker.join();
+		}
+	}
+
+	uint32_t num_threads() const
+	{
+		return workers_.size() + 1u;
+	}
+
+	/*! \brief Calls ``fn(i)`` for every ``i`` in ``[0, num_tasks)``.
+	 *
+	 * Tasks are handed out dynamically, one index at a time, so they can
+	 * have very different running times.  Returns once all tasks finished.
+	 */
+	template<typename Fn>
+	void parallel_for(uint32_t num_tasks, Fn&& fn)
+	{
+		if (num_tasks == 0u) {
+			return;
+		}
+		auto batch = std::make_shared<Batch>();
+		// Workers that pick up a drain job after all indices were handed
+		// out never touch `fn`, so capturing it by reference is fine.
+		auto drain = [batch, num_tasks, &fn]() {
+			uint32_t i;
+			while ((i = batch->next.fetch_add(1u)) < num_tasks) {
+				fn(i);
+				if (batch->done.fetch_add(1u) + 1u == num_tasks) {
+					std::lock_guard<std::mutex> lock(batch->mutex);
+					batch->finished.notify_all();
+				}
+			}
+		};
+		uint32_t const num_jobs
+		    = std::min<uint32_t>(workers_.size(), num_tasks - 1u);
+		if (num_jobs) {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				for (uint32_t i = 0u; i < num_jobs; ++i) {
+					jobs_.emplace_back(drain);
+				}
+			}
+			condition_.notify_all();
+		}
+		drain();
+		std::unique_lock<std::mutex> lock(batch->mutex);
+		batch->finished.wait(lock, [&]() {
+			return batch->done.load() == num_tasks;
+		});
+	}
+
+private:
+	struct Batch {
+		std::atomic<uint32_t> next{0u};
+		std::atomic<uint32_t> done{0u};
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+
+	void worker_loop()
+	{
+		while (true) {
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(mutex_);
+				condition_.wait(lock, [this]() {
+					return stop_ || !jobs_.empty();
+				});
+				if (stop_ && jobs_.empty()) {
+					return;
+				}
+				job = std::move(jobs_.front());
+				jobs_.pop_front();
+			}
+			job();
+		}
+	}
+
+	bool stop_;
+	std::mutex mutex_;
+	std::condition_variable condition_;
+	std::deque<std::function<void()>> jobs_;
+	std::vector<std::thread> workers_;
+};
+
+} // namespace tweedledum
@@ -0,0 +1,346 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "BitOps.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+// Fast Walsh-Hadamard transform (FWHT) and related passes over the 2^n values
+// of a function of n variables, e.g., the angles of a diagonal unitary.
+//
+// The transform is done in place in two phases.  First, blocks that fit in the
+// cache go through all the stages that stay within them.  Then, the remaining
+// stages are done two at a time (radix-4), so each pass over the whole array
+// does twice the work.  Both phases split the work into independent tasks for
+// the thread pool, and the butterflies on `double` use AVX2 or AVX-512 when the
+// CPU supports them (see BitOps.h for the dispatch).
+namespace tweedledum {
+
+#pragma region Implementation details
+namespace walsh_hadamard_detail {
+
+// 2^13 doubles (64KiB) per block, i.e., half of a typical L2 cache.
+constexpr std::size_t block_size = std::size_t(1) << 13;
+// Below this size, the transform is not worth spawning threads.
+constexpr std::size_t min_parallel_size = std::size_t(1) << 16;
+
+#pragma region Scalar
+// (a, b) <- (a + b, a - b)
+template<typename T>
+inline void butterfly2_scalar(T* a, T* b, std::size_t n)
+{
+	for (std::size_t i = 0u; i < n; ++i) {
+		T const t = a[i];
+		a[i] = t + b[i];
+		b[i] = t - b[i];
+	}
+}
+
+// Two stages at once: (a, b), (c, d) and then (a, c), (b, d)
+template<typename T>
+inline void butterfly4_scalar(T* a, T* b, T* c, T* d, std::size_t n)
+{
+	for (std::size_t i = 0u; i < n; ++i) {
+		T const s0 = a[i] + b[i];
+		T const d0 = a[i] - b[i];
+		T const s1 = c[i] + d[i];
+		T const d1 = c[i] - d[i];
+		a[i] = s0 + s1;
+		b[i] = d0 + d1;
+		c[i] = s0 - s1;
+		d[i] = d0 - d1;
+	}
+}
+
+template<typename T>
+inline void negate_copy_scalar(T* dst, T const* src, std::size_t n)
+{
+	for (std::size_t i = 0u; i < n; ++i) {
+		dst[i] = -src[i];
+	}
+}
+#pragma endregion
+
+#if defined(TWEEDLEDUM_X86_SIMD)
+#pragma region AVX2
+#define TWEEDLEDUM_AVX2 __attribute__((target("avx2")))
+
+TWEEDLEDUM_AVX2 inline void butterfly2_avx2(double* a, double* b, std::size_t n)
+{
+	std::size_t i = 0u;
+	for (; i + 4u <= n; i += 4u) {
+		__m256d const x = _mm256_loadu_pd(a + i);
+		__m256d const y = _mm256_loadu_pd(b + i);
+		_mm256_storeu_pd(a + i, _mm256_add_pd(x, y));
+		_mm256_storeu_pd(b + i, _mm256_sub_pd(x, y));
+	}
+	butterfly2_scalar(a + i, b + i, n - i);
+}
+
+TWEEDLEDUM_AVX2 inline void butterfly4_avx2(
+    double* a, double* b, double* c, double* d, std::size_t n)
+{
+	std::size_t i = 0u;
+	for (; i + 4u <= n; i += 4u) {
+		__m256d const xa = _mm256_loadu_pd(a + i);
+		__m256d const xb = _mm256_loadu_pd(b + i);
+		__m256d const xc = _mm256_loadu_pd(c + i);
+		__m256d const xd = _mm256_loadu_pd(d + i);
+		__m256d const s0 = _mm256_add_pd(xa, xb);
+		__m256d const d0 = _mm256_sub_pd(xa, xb);
+		__m256d const s1 = _mm256_add_pd(xc, xd);
+		__m256d const d1 = _mm256_sub_pd(xc, xd);
+		_mm256_storeu_pd(a + i, _mm256_add_pd(s0, s1));
+		_mm256_storeu_pd(b + i, _mm256_add_pd(d0, d1));
+		_mm256_storeu_pd(c + i, _mm256_sub_pd(s0, s1));
+		_mm256_storeu_pd(d + i, _mm256_sub_pd(d0, d1));
+	}
+	butterfly4_scalar(a + i, b + i, c + i, d + i, n - i);
+}
+
+TWEEDLEDUM_AVX2 inline void negate_copy_avx2(
+    double* dst, double const* src, std::size_t n)
+{
+	__m256d const sign = _mm256_set1_pd(-0.0);
+	std::size_t i = 0u;
+	for (; i + 4u <= n; i += 4u) {
+		__m256d const x = _mm256_loadu_pd(src + i);
+		_mm256_storeu_pd(dst + i, _mm256_xor_pd(x, sign));
+	}
+	negate_copy_scalar(dst + i, src + i, n - i);
+}
+
+#undef TWEEDLEDUM_AVX2
+#pragma endregion
+
+#pragma region AVX-512
+#define TWEEDLEDUM_AVX512 __attribute__((target("avx512f")))
+
+TWEEDLEDUM_AVX512 inline void butterfly2_avx512(
+    double* a, double* b, std::size_t n)
+{
+	std::size_t i = 0u;
+	for (; i + 8u <= n; i += 8u) {
+		__m512d const x = _mm512_loadu_pd(a + i);
+		__m512d const y = _mm512_loadu_pd(b + i);
+		_mm512_storeu_pd(a + i, _mm512_add_pd(x, y));
+		_mm512_storeu_pd(b + i, _mm512_sub_pd(x, y));
+	}
+	butterfly2_scalar(a + i, b + i, n - i);
+}
+
+TWEEDLEDUM_AVX512 inline void butterfly4_avx512(
+    double* a, double* b, double* c, double* d, std::size_t n)
+{
+	std::size_t i = 0u;
+	for (; i + 8u <= n; i += 8u) {
+		__m512d const xa = _mm512_loadu_pd(a + i);
+		__m512d const xb = _mm512_loadu_pd(b + i);
+		__m512d const xc = _mm512_loadu_pd(c + i);
+		__m512d const xd = _mm512_loadu_pd(d + i);
+		__m512d const s0 = _mm512_add_pd(xa, xb);
+		__m512d const d0 = _mm512_sub_pd(xa, xb);
+		__m512d const s1 = _mm512_add_pd(xc, xd);
+		__m512d const d1 = _mm512_sub_pd(xc, xd);
+		_mm512_storeu_pd(a + i, _mm512_add_pd(s0, s1));
+		_mm512_storeu_pd(b + i, _mm512_add_pd(d0, d1));
+		_mm512_storeu_pd(c + i, _mm512_sub_pd(s0, s1));
+		_mm512_storeu_pd(d + i, _mm512_sub_pd(d0, d1));
+	}
+	butterfly4_scalar(a + i, b + i, c + i, d + i, n - i);
+}
+
+TWEEDLEDUM_AVX512 inline void negate_copy_avx512(
+    double* dst, double const* src, std::size_t n)
+{
+	__m512i const sign = _mm512_set1_epi64(INT64_MIN);
+	std::size_t i = 0u;
+	for (; i + 8u <= n; i += 8u) {
+		__m512i const x = _mm512_castpd_si512(_mm512_loadu_pd(src + i));
+		_mm512_storeu_pd(
+		    dst + i, _mm512_castsi512_pd(_mm512_xor_si512(x, sign)));
+	}
+	negate_copy_scalar(dst + i, src + i, n - i);
+}
+
+#undef TWEEDLEDUM_AVX512
+#pragma endregion
+#endif
+
+// Picks the SIMD variant for doubles, and the scalar one otherwise.
+#if defined(TWEEDLEDUM_X86_SIMD)
+#define TWEEDLEDUM_DISPATCH(name, T, ...)                                      \
+	do {                                                                   \
+		if constexpr (std::is_same_v<T, double>) {                     \
+			switch (simd_isa()) {                                  \
+			case SimdIsa::avx512:                                  \
+				return name##_avx512(__VA_ARGS__);             \
+			case SimdIsa::avx2:                                    \
+				return name##_avx2(__VA_ARGS__);               \
+			default:                                               \
+				break;                                         \
+			}                                                      \
+		}                                                              \
+		return name##_scalar(__VA_ARGS__);                             \
+	} while (0)
+#else
+#define TWEEDLEDUM_DISPATCH(name, T, ...) return name##_scalar(__VA_ARGS__)
+#endif
+
+template<typename T>
+inline void butterfly2(T* a, T* b, std::size_t n)
+{
+	TWEEDLEDUM_DISPATCH(butterfly2, T, a, b, n);
+}
+
+template<typename T>
+inline void butterfly4(T* a, T* b, T* c, T* d, std::size_t n)
+{
+	TWEEDLEDUM_DISPATCH(butterfly4, T, a, b, c, d, n);
+}
+
+template<typename T>
+inline void negate_copy(T* dst, T const* src, std::size_t n)
+{
+	TWEEDLEDUM_DISPATCH(negate_copy, T, dst, src, n);
+}
+
+#undef TWEEDLEDUM_DISPATCH
+
+// Does all the stages of the transform of a block of `size` values, i.e., the
+// butterflies between values at distance m = 1, 2, 4, ..., size / 2.
+template<typename T>
+inline void transform_block(T* data, std::size_t size)
+{
+	std::size_t m = 1u;
+	// The first two stages work within groups of 4 consecutive values,
+	// which is too short for vectors.
+	if (size >= 4u) {
+		for (std::size_t i = 0u; i < size; i += 4u) {
+			butterfly4_scalar(data + i, data + i + 1u, data + i + 2u,
+			    data + i + 3u, 1u);
+		}
+		m = 4u;
+	}
+	for (; (m << 1) < size; m <<= 2) {
+		for (std::size_t i = 0u; i < size; i += (m << 2)) {
+			T* a = data + i;
+			butterfly4(a, a + m, a + 2 * m, a + 3 * m, m);
+		}
+	}
+	if (m < size) {
+		for (std::size_t i = 0u; i < size; i += (m << 1)) {
+			butterfly2(data + i, data + i + m, m);
+		}
+	}
+}
+
+} // namespace walsh_hadamard_detail
+#pragma endregion
+
+/*! \brief In-place fast Walsh-Hadamard transform.
+ *
+ * Computes ``y[w] = sum_x (-1)^(w . x) data[x]``, where ``w . x`` is the parity
+ * of ``w & x``.  The transform is not normalized: applying it twice multiplies
+ * the values by ``size``.
+ *
+ * \param[inout] data Values to be transformed.
+ * \param[in] size Number of values, a power of two.
+ * \param[in] num_threads Number of threads (0 means one per hardware thread).
+ * Small inputs are always transformed by the calling thread alone.
+ */
+template<typename T>
+inline void walsh_hadamard_transform(
+    T* data, std::size_t size, uint32_t num_threads = 0u)
+{
+	using namespace walsh_hadamard_detail;
+	assert(size > 0u && !(size & (size - 1u)));
+	std::size_t const block = std::min(size, block_size);
+	if (size < min_parallel_size || num_threads == 1u) {
+		for (std::size_t i = 0u; i < size; i += block) {
+			transform_block(data + i, block);
+		}
+		for (std::size_t m = block; m < size; m <<= 2) {
+			bool const pair = (m << 1) < size;
+			for (std::size_t i = 0u; i < size; i += (m << (pair + 1))) {
+				T* a = data + i;
+				if (pair) {
+					butterfly4(a, a + m, a + 2 * m, a + 3 * m, m);
+				} else {
+					butterfly2(a, a + m, m);
+				}
+			}
+		}
+		return;
+	}
+
+	ThreadPool pool(num_threads);
+	pool.parallel_for(size / block, [&](uint32_t i) {
+		transform_block(data + (i * block), block);
+	});
+	// Each task does a chunk of `block / 4` butterflies of one group.
+	std::size_t const chunk = block >> 2;
+	for (std::size_t m = block; m < size; m <<= 2) {
+		bool const pair = (m << 1) < size;
+		std::size_t const group = m << (pair + 1);
+		std::size_t const chunks_per_group = m / chunk;
+		pool.parallel_for(size / group * chunks_per_group, [&](uint32_t i) {
+			std::size_t const offset = (i / chunks_per_group) * group
+			                           + (i % chunks_per_group) * chunk;
+			T* a = data + offset;
+			if (pair) {
+				butterfly4(a, a + m, a + 2 * m, a + 3 * m, chunk);
+			} else {
+				butterfly2(a, a + m, chunk);
+			}
+		});
+	}
+}
+
+template<typename T>
+inline void walsh_hadamard_transform(
+    std::vector<T>& data, uint32_t num_threads = 0u)
+{
+	walsh_hadamard_transform(data.data(), data.size(), num_threads);
+}
+
+/*! \brief Complements variables of a function given by its values.
+ *
+ * Sets ``out[x] = in[x ^ mask]`` for every ``x``, negating the values when
+ * ``negate`` is true.  Flipping the bits in ``mask`` preserves every aligned
+ * run of ``2^ctz(mask)`` consecutive values, which are copied as a whole.
+ *
+ * \param[in] in Input values.
+ * \param[out] out Output values, must not overlap with the input.
+ * \param[in] size Number of values, a power of two.
+ * \param[in] mask Variables to complement.
+ * \param[in] negate Whether to negate the values.
+ */
+template<typename T>
+inline void xor_permute(T const* in, T* out, std::size_t size, uint64_t mask,
+    bool negate = false)
+{
+	using namespace walsh_hadamard_detail;
+	assert(size > 0u && !(size & (size - 1u)));
+	assert(mask < size);
+	std::size_t const run = mask ? (std::size_t(1) << __builtin_ctzll(mask))
+	                             : size;
+	for (std::size_t x = 0u; x < size; x += run) {
+		if (negate) {
+			negate_copy(out + x, in + (x ^ mask), run);
+		} else {
+			std::copy_n(in + (x ^ mask), run, out + x);
+		}
+	}
+}
+
+} // namespace tweedledum
@@ -0,0 +1,110 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/algorithms/optimization/dihedral_resynth.h"
+
+#include "tweedledum/algorithms/verification/unitary_verify.h"
+#include "tweedledum/generators/adder.h"
+#include "tweedledum/ir/Circuit.h"
+#include "tweedledum/ir/GateLib.h"
+#include "tweedledum/ir/Wire.h"
+
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+using namespace tweedledum;
+
+uint32_t count_cnots(Circuit const& circuit)
+{
+	uint32_t num_cnots = 0u;
+	for (Instruction const& inst : circuit) {
+		num_cnots += inst.is<GateLib::X>()
+		             && std::distance(inst.begin(), inst.end()) == 2;
+	}
+	return num_cnots;
+}
+
+} // namespace
+
+TEST_CASE("CNOT-dihedral region resynthesis", "[dihedral][optimization]")
+{
+	using namespace tweedledum;
+	SECTION("Cancel CNOTs around rotations")
+	{
+		Circuit circuit("circuit");
+		WireRef q0 = circuit.create_qubit();
+		WireRef q1 = circuit.create_qubit();
+		WireRef q2 = circuit.create_qubit();
+		circuit.create_instruction(GateLib::X(), {q0}, q1);
+		circuit.create_instruction(GateLib::R1(0.3), {q0});
+		circuit.create_instruction(GateLib::X(), {q0}, q1);
+		circuit.create_instruction(GateLib::H(), {q2});
+		circuit.create_instruction(GateLib::X(), {q1}, q2);
+		circuit.create_instruction(GateLib::X(), {q1}, q2);
+		circuit.create_instruction(GateLib::R1(0.4), {q2});
+		circuit.create_instruction(GateLib::H(), {q2});
+		circuit.create_instruction(GateLib::X(), {q0}, q2);
+
+		Circuit optimized = dihedral_resynth(circuit);
+		CHECK(optimized.num_qubits() == circuit.num_qubits());
+		CHECK(count_cnots(optimized) == 1u);
+		CHECK(unitary_verify(optimized, circuit));
+	}
+	SECTION("Random circuits")
+	{
+		std::mt19937 rng(7u);
+		for (uint32_t round = 0u; round < 20u; ++round) {
+			Circuit circuit("circuit");
+			std::vector<WireRef> qubits;
+			for (uint32_t i = 0u; i < 4u; ++i) {
+				qubits.push_back(circuit.create_qubit());
+			}
+			for (uint32_t i = 0u; i < 40u; ++i) {
+				std::shuffle(qubits.begin(), qubits.end(), rng);
+				WireRef const a = qubits[0];
+				WireRef const b = qubits[1];
+				WireRef const c = qubits[2];
+				switch (rng() % 10u) {
+				case 0:
+					circuit.create_instruction(GateLib::H(), {a});
+					break;
+				case 1:
+					circuit.create_instruction(GateLib::X(), {a, b}, c);
+					break;
+				case 2:
+				case 3:
+					circuit.create_instruction(
+					    GateLib::R1(0.1 * (rng() % 31u)), {a});
+					break;
+				case 4:
+					circuit.create_instruction(GateLib::X(), {a});
+					break;
+				case 5:
+					circuit.create_instruction(GateLib::X(), {!a}, b);
+					break;
+				default:
+					circuit.create_instruction(GateLib::X(), {a}, b);
+					break;
+				}
+			}
+			Circuit optimized = dihedral_resynth(circuit, 2u);
+			CHECK(count_cnots(optimized) <= count_cnots(circuit));
+			// X gates and negative controls lead to complemented
+			// outputs and global phases.
+			CHECK(unitary_verify(
+			    optimized, circuit, 1e-05, 1e-08, true));
+		}
+	}
+	SECTION("Adder")
+	{
+		Circuit circuit = carry_ripple_adder_inplace(3u);
+		Circuit optimized = dihedral_resynth(circuit);
+		CHECK(count_cnots(optimized) <= count_cnots(circuit));
+		CHECK(unitary_verify(optimized, circuit));
+	}
+}
@@ -0,0 +1,138 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/algorithms/optimization/phase_folding.h"
+
+#include "tweedledum/algorithms/verification/unitary_verify.h"
+#include "tweedledum/ir/Circuit.h"
+#include "tweedledum/ir/GateLib.h"
+#include "tweedledum/ir/Wire.h"
+
+#include <algorithm>
+#include <catch.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+using namespace tweedledum;
+
+uint32_t count_rotations(Circuit const& circuit)
+{
+	uint32_t num_rotations = 0u;
+	for (Instruction const& inst : circuit) {
+		num_rotations += inst.is<GateLib::R1>();
+	}
+	return num_rotations;
+}
+
+} // namespace
+
+TEST_CASE("Phase folding", "[phase_folding][optimization]")
+{
+	using namespace tweedledum;
+	SECTION("Merge rotations on the same parity")
+	{
+		Circuit circuit("circuit");
+		WireRef q0 = circuit.create_qubit();
+		WireRef q1 = circuit.create_qubit();
+		circuit.create_instruction(GateLib::R1(M_PI_4), {q1});
+		circuit.create_instruction(GateLib::X(), {q0}, q1);
+		circuit.create_instruction(GateLib::R1(0.3), {q1});
+		circuit.create_instruction(GateLib::X(), {q1}, q0);
+		circuit.create_instruction(GateLib::X(), {q0}, q1);
+		circuit.create_instruction(GateLib::R1(M_PI_4), {q0});
+		circuit.create_instruction(GateLib::X(), {q1}, q0);
+		circuit.create_instruction(GateLib::R1(0.2), {q0});
+
+		Circuit folded = phase_folding(circuit);
+		CHECK(count_rotations(folded) == 2u);
+		CHECK(folded.size() == circuit.size() - 2u);
+		CHECK(unitary_verify(folded, circuit));
+	}
+	SECTION("Non-linear gates give fresh variables")
+	{
+		Circuit circuit("circuit");
+		WireRef q0 = circuit.create_qubit();
+		WireRef q1 = circuit.create_qubit();
+		WireRef q2 = circuit.create_qubit();
+		circuit.create_instruction(GateLib::R1(0.1), {q0});
+		circuit.create_instruction(GateLib::H(), {q0});
+		circuit.create_instruction(GateLib::R1(0.1), {q0});
+		circuit.create_instruction(GateLib::R1(0.2), {q2});
+		circuit.create_instruction(GateLib::X(), {q0, q1}, q2);
+		circuit.create_instruction(GateLib::R1(0.2), {q2});
+		circuit.create_instruction(GateLib::R1(0.3), {q1});
+		circuit.create_instruction(GateLib::R1(0.3), {q1});
+
+		Circuit folded = phase_folding(circuit);
+		CHECK(count_rotations(folded) == 5u);
+		CHECK(unitary_verify(folded, circuit));
+	}
+	SECTION("Remove rotations summing up to zero")
+	{
+		Circuit circuit("circuit");
+		WireRef q0 = circuit.create_qubit();
+		WireRef q1 = circuit.create_qubit();
+		circuit.create_instruction(GateLib::R1(1.5), {q0});
+		circuit.create_instruction(GateLib::X(), {q0});
+		circuit.create_instruction(GateLib::R1(1.5), {q0});
+		circuit.create_instruction(GateLib::X(), {q0});
+		circuit.create_instruction(GateLib::R1(M_PI), {q1});
+		circuit.create_instruction(GateLib::R1(M_PI), {q1});
+
+		// Up to the global phase e^(1.5i)
+		Circuit folded = phase_folding(circuit);
+		CHECK(folded.size() == 2u);
+		CHECK(count_rotations(folded) == 0u);
+		CHECK(unitary_verify(folded, circuit, 1e-05, 1e-08, true));
+	}
+	SECTION("Random circuits")
+	{
+		std::mt19937 rng(11u);
+		for (uint32_t round = 0u; round < 20u; ++round) {
+			Circuit circuit("circuit");
+			std::vector<WireRef> qubits;
+			for (uint32_t i = 0u; i < 4u; ++i) {
+				qubits.push_back(circuit.create_qubit());
+			}
+			for (uint32_t i = 0u; i < 40u; ++i) {
+				std::shuffle(qubits.begin(), qubits.end(), rng);
+				switch (rng() % 10u) {
+				case 0:
+					circuit.create_instruction(GateLib::H(), {qubits[0]});
+					break;
+				case 1:
+					circuit.create_instruction(
+					    GateLib::X(), {qubits[0], qubits[1]}, qubits[2]);
+					break;
+				case 2:
+					circuit.create_instruction(
+					    GateLib::R1(M_PI_4), {qubits[0]}, qubits[1]);
+					break;
+				case 3:
+				case 4:
+					circuit.create_instruction(
+					    GateLib::R1(M_PI_4 * (rng() % 8u)), {qubits[0]});
+					break;
+				case 5:
+					circuit.create_instruction(GateLib::X(), {qubits[0]});
+					break;
+				case 6:
+					circuit.create_instruction(
+					    GateLib::X(), {!qubits[0]}, qubits[1]);
+					break;
+				default:
+					circuit.create_instruction(
+					    GateLib::X(), {qubits[0]}, qubits[1]);
+					break;
+				}
+			}
+			Circuit folded = phase_folding(circuit);
+			CHECK(count_rotations(folded) <= count_rotations(circuit));
+			CHECK(unitary_verify(
+			    folded, circuit, 1e-05, 1e-08, true));
+		}
+	}
+}
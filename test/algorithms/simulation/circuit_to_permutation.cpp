@@ -0,0 +1,56 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/algorithms/simulation/circuit_to_permutation.h"
+
+#include "tweedledum/algorithms/synthesis/decomp_synth.h"
+#include "tweedledum/algorithms/synthesis/transform_synth.h"
+#include "tweedledum/ir/Circuit.h"
+#include "tweedledum/ir/GateLib.h"
+#include "tweedledum/ir/Wire.h"
+
+#include <algorithm>
+#include <catch.hpp>
+#include <numeric>
+#include <random>
+#include <vector>
+
+TEST_CASE("Extract permutation from reversible circuit", "[circuit_to_permutation]")
+{
+	using namespace tweedledum;
+	SECTION("Toffoli gate circuit")
+	{
+		Circuit circuit("my_circuit");
+		WireRef q0 = circuit.create_qubit();
+		WireRef q1 = circuit.create_qubit();
+		WireRef q2 = circuit.create_qubit();
+		circuit.create_instruction(GateLib::X(), {q1, q2, q0});
+		std::vector<uint32_t> expected = {0, 1, 2, 3, 4, 5, 7, 6};
+		CHECK(circuit_to_permutation(circuit) == expected);
+	}
+	SECTION("Negative controls")
+	{
+		Circuit circuit("my_circuit");
+		WireRef q0 = circuit.create_qubit();
+		WireRef q1 = circuit.create_qubit();
+		circuit.create_instruction(GateLib::X(), {!q0}, q1);
+		std::vector<uint32_t> expected = {2, 1, 0, 3};
+		CHECK(circuit_to_permutation(circuit) == expected);
+	}
+	SECTION("Random permutations (TBS and DBS)")
+	{
+		std::mt19937 gen(42);
+		for (uint32_t num_qubits = 1u; num_qubits <= 10u; ++num_qubits) {
+			std::vector<uint32_t> perm(1u << num_qubits);
+			std::iota(perm.begin(), perm.end(), 0u);
+			std::shuffle(perm.begin(), perm.end(), gen);
+			Circuit tbs = transform_synth(perm);
+			CHECK(circuit_to_permutation(tbs, 1u) == perm);
+			CHECK(circuit_to_permutation(tbs, 4u) == perm);
+			Circuit dbs = decomp_synth(perm);
+			CHECK(circuit_to_permutation(dbs, 1u) == perm);
+			CHECK(circuit_to_permutation(dbs, 3u) == perm);
+		}
+	}
+}
@@ -11,6 +11,8 @@
 
 #include <catch.hpp>
 #include <kitty/kitty.hpp>
+#include <random>
+#include <vector>
 
 TEST_CASE("Simulate reversible circuit", "[simulate_classically]")
 {
@@ -52,4 +54,66 @@ TEST_CASE("Simulate reversible circuit", "[simulate_classically]")
 			CHECK(result == permutation[i]);
 		}
 	}
+	SECTION("Parity gate circuit")
+	{
+		circuit.create_instruction(GateLib::Parity(), {q0, !q1, q2});
+		for (uint32_t i = 0; i < 8u; ++i) {
+			DynamicBitset<uint8_t> pattern(3, i);
+			uint32_t const parity = (i ^ (i >> 1) ^ 1u) & 1u;
+			DynamicBitset<uint8_t> expected(3, i ^ (parity << 2));
+			auto result = simulate_classically(circuit, pattern);
+			CHECK(result == expected);
+		}
+	}
+}
+
+TEST_CASE("Bit-parallel simulation", "[simulate_classically]")
+{
+	using namespace tweedledum;
+	std::mt19937 gen(1);
+	Circuit circuit("my_circuit");
+	std::vector<WireRef> qubits;
+	for (uint32_t i = 0u; i < 8u; ++i) {
+		qubits.push_back(circuit.create_qubit());
+	}
+	std::vector<kitty::dynamic_truth_table> tts;
+	for (uint32_t num_vars = 0; num_vars < 5u; ++num_vars) {
+		auto& tt = tts.emplace_back(num_vars);
+		kitty::create_random(tt, gen());
+	}
+	for (uint32_t i = 0u; i < 200u; ++i) {
+		std::vector<WireRef> wires = qubits;
+		std::shuffle(wires.begin(), wires.end(), gen);
+		uint32_t const num_controls = gen() % 5u;
+		wires.erase(wires.begin() + num_controls + 1u, wires.end());
+		if (gen() & 1) {
+			wires.front() = !wires.front();
+		}
+		switch (gen() % 3u) {
+		case 0:
+			circuit.create_instruction(GateLib::X(), wires);
+			break;
+		case 1:
+			circuit.create_instruction(GateLib::Parity(), wires);
+			break;
+		default:
+			circuit.create_instruction(
+			    GateLib::TruthTable("f", tts[num_controls]), wires);
+			break;
+		}
+	}
+	std::vector<uint64_t> words(8u);
+	for (uint64_t& word : words) {
+		word = (uint64_t(gen()) << 32) | gen();
+	}
+	auto const result = simulate_classically(circuit, words);
+	for (uint32_t lane = 0u; lane < 64u; ++lane) {
+		DynamicBitset<uint64_t> pattern(8u);
+		DynamicBitset<uint64_t> expected(8u);
+		for (uint32_t i = 0u; i < 8u; ++i) {
+			pattern.set(i, (words[i] >> lane) & 1u);
+			expected.set(i, (result[i] >> lane) & 1u);
+		}
+		CHECK(simulate_classically(circuit, pattern) == expected);
+	}
 }
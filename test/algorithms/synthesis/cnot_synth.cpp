@@ -0,0 +1,185 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/algorithms/synthesis/cnot_synth.h"
+
+#include "tweedledum/algorithms/simulation/circuit_to_phase_poly.h"
+#include "tweedledum/ir/Circuit.h"
+#include "tweedledum/ir/GateLib.h"
+#include "tweedledum/ir/Wire.h"
+#include "tweedledum/support/BitMatrix.h"
+#include "tweedledum/support/Matrix.h"
+
+#include <catch.hpp>
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace {
+using namespace tweedledum;
+
+inline BitMatrix random_invertible(uint32_t num_qubits, uint32_t seed)
+{
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<uint32_t> dist(0u, num_qubits - 1u);
+	BitMatrix matrix = BitMatrix::Identity(num_qubits);
+	for (uint32_t i = 0u; i < 8u * num_qubits; ++i) {
+		uint32_t const row = dist(gen);
+		uint32_t const other = dist(gen);
+		if (row != other) {
+			matrix.row_xor(row, other);
+		}
+	}
+	return matrix;
+}
+
+// Checks that the circuit implements the matrix, i.e., row `i` of the matrix
+// is the parity that qubit `i` holds at the end.
+inline bool implements(Circuit const& circuit, BitMatrix const& matrix)
+{
+	auto const form = circuit_to_phase_poly(circuit);
+	if (!form || form->complemented.any()) {
+		return false;
+	}
+	for (uint32_t i = 0u; i < matrix.num_rows(); ++i) {
+		if (form->linear_trans[i] != matrix.row(i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+TEST_CASE("Bit-packed GF(2) matrices", "[bit_matrix]")
+{
+	using namespace tweedledum;
+	BitMatrix matrix(3, 70);
+	matrix.set(0, 1);
+	matrix.set(0, 69);
+	matrix.set(1, 69);
+	matrix.set(2, 0);
+	CHECK(matrix.row_words() == 2u);
+	CHECK(matrix.row_weight(0) == 2u);
+	CHECK(matrix.column_weight(69) == 2u);
+	matrix.row_xor(1, 0);
+	CHECK(matrix(1, 1));
+	CHECK_FALSE(matrix(1, 69));
+	CHECK(matrix.column(69).count() == 1u);
+	matrix.swap_rows(0, 2);
+	CHECK(matrix.row_weight(0) == 1u);
+	CHECK(matrix(2, 69));
+	BitMatrix const transposed = transpose(matrix);
+	CHECK(transposed.num_rows() == 70u);
+	CHECK(transposed(69, 2));
+	CHECK(transpose(transposed) == matrix);
+}
+
+TEST_CASE("Transpose bit matrices", "[bit_matrix]")
+{
+	using namespace tweedledum;
+	std::mt19937 gen(1u);
+	std::bernoulli_distribution coin;
+	for (auto [rows, cols] : {std::pair{1u, 1u}, {7u, 130u}, {64u, 64u},
+	         {65u, 65u}, {200u, 200u}, {129u, 3u}}) {
+		BitMatrix matrix(rows, cols);
+		for (uint32_t i = 0u; i < rows; ++i) {
+			for (uint32_t j = 0u; j < cols; ++j) {
+				matrix.set(i, j, coin(gen));
+			}
+		}
+		BitMatrix const transposed = transpose(matrix);
+		REQUIRE(transposed.num_rows() == cols);
+		REQUIRE(transposed.num_columns() == rows);
+		bool all_equal = true;
+		for (uint32_t i = 0u; i < rows; ++i) {
+			for (uint32_t j = 0u; j < cols; ++j) {
+				all_equal &= (matrix(i, j) == transposed(j, i));
+			}
+		}
+		CHECK(all_equal);
+		if (rows == cols) {
+			BitMatrix copy = matrix;
+			transpose_inplace(copy);
+			CHECK(copy == transposed);
+			transpose_inplace(copy);
+			CHECK(copy == matrix);
+		}
+	}
+}
+
+TEST_CASE("Synthesize linear reversible circuits", "[cnot_synth][synth]")
+{
+	using namespace tweedledum;
+	SECTION("Byte matrix")
+	{
+		Matrix<uint8_t> matrix = {{1, 1, 0}, {0, 1, 0}, {1, 1, 1}};
+		Circuit const circuit = cnot_synth(matrix);
+		CHECK(implements(circuit, BitMatrix(matrix)));
+	}
+	SECTION("Random matrices")
+	{
+		for (uint32_t num_qubits : {2u, 5u, 16u, 63u, 64u, 65u, 300u}) {
+			BitMatrix const matrix
+			    = random_invertible(num_qubits, num_qubits);
+			Circuit const circuit = cnot_synth(matrix);
+			CHECK(implements(circuit, matrix));
+		}
+	}
+	SECTION("Section sizes")
+	{
+		BitMatrix const matrix = random_invertible(100u, 7u);
+		for (uint32_t section_size = 1u; section_size < 9u; ++section_size) {
+			Circuit const circuit = cnot_synth(matrix, section_size);
+			CHECK(implements(circuit, matrix));
+		}
+		// Bigger sections pay off on larger matrices
+		BitMatrix const large = random_invertible(256u, 7u);
+		CHECK(cnot_synth(large).size() < cnot_synth(large, 2u).size());
+	}
+}
+
+TEST_CASE("Portfolio CNOT synthesis", "[cnot_synth][synth]")
+{
+	using namespace tweedledum;
+	for (uint32_t num_qubits : {1u, 3u, 40u, 130u}) {
+		BitMatrix const matrix = random_invertible(num_qubits, 3u);
+		Circuit const circuit = cnot_synth_portfolio(matrix, 2u);
+		CHECK(implements(circuit, matrix));
+		CHECK(circuit.size() <= cnot_synth(matrix).size());
+	}
+	SECTION("Time budget")
+	{
+		BitMatrix const matrix = random_invertible(200u, 5u);
+		Circuit const circuit = cnot_synth_portfolio(
+		    matrix, 8u, 2u, std::chrono::milliseconds(1));
+		CHECK(implements(circuit, matrix));
+	}
+}
+
+TEST_CASE("Batch CNOT synthesis", "[cnot_synth][synth]")
+{
+	using namespace tweedledum;
+	std::vector<BitMatrix> matrices;
+	for (uint32_t i = 0u; i < 100u; ++i) {
+		matrices.push_back(random_invertible(8u + (i % 25u), i));
+	}
+	auto const results = cnot_synth_batch(matrices);
+	REQUIRE(results.size() == matrices.size());
+	for (uint32_t i = 0u; i < matrices.size(); ++i) {
+		uint32_t const num_qubits = matrices[i].num_rows();
+		Circuit circuit("batch");
+		std::vector<WireRef> qubits;
+		for (uint32_t j = 0u; j < num_qubits; ++j) {
+			qubits.push_back(circuit.create_qubit());
+		}
+		for (auto const& [control, target] : results[i]) {
+			circuit.create_instruction(
+			    GateLib::X(), {qubits[control]}, qubits[target]);
+		}
+		CHECK(implements(circuit, matrices[i]));
+		CHECK(results[i].size() == cnot_synth(matrices[i]).size());
+	}
+	CHECK(cnot_synth_batch({}).empty());
+}
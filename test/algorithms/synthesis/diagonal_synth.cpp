@@ -8,6 +8,8 @@
 #include "tweedledum/ir/Circuit.h"
 #include "tweedledum/ir/GateLib.h"
 #include "tweedledum/ir/Wire.h"
+#include "tweedledum/support/DynamicBitset.h"
+#include "tweedledum/support/LinearPP.h"
 
 #include <catch.hpp>
 
@@ -28,3 +30,129 @@ TEST_CASE("Synthesize diagonal unitaries", "[diagonal][synth]")
 		CHECK(unitary_verify(circuit0, circuit1));
 	}
 }
+
+TEST_CASE("Synthesize diagonal unitaries on complemented qubits",
+    "[diagonal][synth]")
+{
+	using namespace tweedledum;
+	std::vector<double> const angles
+	    = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8};
+	for (uint32_t mask = 1u; mask < angles.size(); ++mask) {
+		Circuit circuit0("complemented");
+		std::vector<WireRef> qubits;
+		for (uint32_t i = 0u; i < 3u; ++i) {
+			qubits.push_back(circuit0.create_qubit());
+			if ((mask >> i) & 1) {
+				qubits.back().complement();
+			}
+		}
+		diagonal_synth(circuit0, qubits, angles);
+
+		// Complementing qubit i flips bit i of the index of the angles.
+		std::vector<double> flipped(angles.size());
+		for (uint32_t x = 0u; x < angles.size(); ++x) {
+			flipped[x] = angles[x ^ mask];
+		}
+		CHECK(unitary_verify(circuit0, diagonal_synth(flipped)));
+	}
+}
+
+TEST_CASE("Approximate synthesis of diagonal unitaries", "[diagonal][synth]")
+{
+	using namespace tweedledum;
+	// Two parities, x0 + x1 and x0 + x2, blurred by some numerical noise
+	uint32_t const num_qubits = 4u;
+	std::vector<double> angles(1u << num_qubits);
+	for (uint32_t x = 0u; x < angles.size(); ++x) {
+		angles[x] = 0.7 * (__builtin_popcount(x & 0x3) & 1)
+		            + 1.1 * (__builtin_popcount(x & 0x5) & 1)
+		            + 1e-12 * ((x * 7u) % 5u);
+	}
+	Circuit exact("exact");
+	Circuit approx("approx");
+	std::vector<WireRef> exact_qubits;
+	std::vector<WireRef> approx_qubits;
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		exact_qubits.push_back(exact.create_qubit());
+		approx_qubits.push_back(approx.create_qubit());
+	}
+	CHECK(diagonal_synth(exact, exact_qubits, angles) == 0.0);
+	double const error = diagonal_synth(approx, approx_qubits, angles, 1e-6);
+	CHECK(error > 0.0);
+	CHECK(error < 1e-9);
+	CHECK(approx.size() < exact.size());
+	CHECK(unitary_verify(approx, exact));
+
+	// Dropping a real term is accounted for in the bound
+	Circuit coarse("coarse");
+	std::vector<WireRef> coarse_qubits;
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		coarse_qubits.push_back(coarse.create_qubit());
+	}
+	double const coarse_error
+	    = diagonal_synth(coarse, coarse_qubits, angles, 0.8);
+	CHECK(coarse_error > 0.7);
+	CHECK(coarse_error <= 2.0);
+	CHECK_FALSE(unitary_verify(coarse, exact));
+}
+
+
+TEST_CASE("Synthesize sparse diagonal unitaries", "[diagonal][synth]")
+{
+	using namespace tweedledum;
+	SECTION("Against the dense variant")
+	{
+		uint32_t const num_qubits = 4u;
+		LinearPP<uint32_t> parities;
+		parities.add_term(0x3u, 0.7);
+		parities.add_term(0x5u, 1.1);
+		parities.add_term(0xeu, -0.4);
+		parities.add_term(0x8u, 1e-9);
+		parities.add_term(0x0u, 0.3);
+		std::vector<double> angles(1u << num_qubits, 0.0);
+		for (auto const& [parity, angle] : parities) {
+			for (uint32_t x = 0u; x < angles.size(); ++x) {
+				angles[x] += angle * (__builtin_popcount(x & parity) & 1);
+			}
+		}
+		for (uint32_t mask = 0u; mask < angles.size(); mask += 5u) {
+			Circuit sparse("sparse");
+			Circuit dense("dense");
+			std::vector<WireRef> sparse_qubits;
+			std::vector<WireRef> dense_qubits;
+			for (uint32_t i = 0u; i < num_qubits; ++i) {
+				sparse_qubits.push_back(sparse.create_qubit());
+				dense_qubits.push_back(dense.create_qubit());
+				if ((mask >> i) & 1) {
+					sparse_qubits.back().complement();
+					dense_qubits.back().complement();
+				}
+			}
+			double const error
+			    = diagonal_synth(sparse, sparse_qubits, parities, 1e-6);
+			CHECK(error == 1e-9);
+			diagonal_synth(dense, dense_qubits, angles);
+			CHECK(unitary_verify(sparse, dense));
+		}
+	}
+	SECTION("Many qubits")
+	{
+		using Parity = DynamicBitset<uint64_t>;
+		uint32_t const num_qubits = 60u;
+		LinearPP<Parity> parities;
+		for (uint32_t i = 0u; i < 200u; ++i) {
+			Parity parity(num_qubits);
+			parity.set((i * 7u) % num_qubits);
+			parity.set((i * 13u + 5u) % num_qubits);
+			parity.set((i * 29u + 11u) % num_qubits);
+			parities.add_term(parity, 0.01 * (i + 1));
+		}
+		Circuit circuit = diagonal_synth(num_qubits, parities);
+		uint32_t num_rotations = 0u;
+		for (Instruction const& inst : circuit) {
+			num_rotations += inst.is<GateLib::R1>();
+		}
+		CHECK(circuit.num_qubits() == num_qubits);
+		CHECK(num_rotations == parities.size());
+	}
+}
@@ -0,0 +1,196 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/algorithms/synthesis/gray_synth.h"
+
+#include "tweedledum/algorithms/simulation/circuit_to_phase_poly.h"
+#include "tweedledum/algorithms/synthesis/all_linear_synth.h"
+#include "tweedledum/algorithms/verification/unitary_verify.h"
+#include "tweedledum/ir/Circuit.h"
+#include "tweedledum/ir/GateLib.h"
+#include "tweedledum/support/DynamicBitset.h"
+#include "tweedledum/support/LinearPP.h"
+
+#include <catch.hpp>
+#include <cmath>
+#include <random>
+
+namespace {
+using namespace tweedledum;
+
+// Whether the circuit implements exactly the phase polynomial `parities`
+// with an identity linear transformation.
+template<typename Parity>
+bool implements(
+    Circuit const& circuit, uint32_t num_qubits, LinearPP<Parity> parities)
+{
+	using FormParity = PhasePolynomial::Parity;
+	auto const form = circuit_to_phase_poly(circuit);
+	if (!form || form->complemented.any()) {
+		return false;
+	}
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		if (form->linear_trans[i]
+		    != parity_var<FormParity>(num_qubits, i)) {
+			return false;
+		}
+	}
+	LinearPP<FormParity> expected;
+	for (auto const& [parity, angle] : parities) {
+		FormParity wide(num_qubits);
+		for (uint32_t i = 0u; i < num_qubits; ++i) {
+			wide.set(i, parity_has_var(parity, i));
+		}
+		expected.add_term(wide, angle);
+	}
+	expected.finalize();
+	if (form->terms.size() != expected.size()) {
+		return false;
+	}
+	auto it = expected.begin();
+	for (auto const& [parity, angle] : form->terms) {
+		if (parity != it->first || std::abs(angle - it->second) > 1e-10) {
+			return false;
+		}
+		++it;
+	}
+	return true;
+}
+
+} // namespace
+
+TEST_CASE("Gray synthesis of wide phase polynomials", "[gray_synth][synth]")
+{
+	using Parity = DynamicBitset<uint64_t>;
+	std::mt19937 gen(17u);
+	std::uniform_real_distribution<double> angle_dist(-M_PI, M_PI);
+	for (uint32_t num_qubits : {8u, 64u, 150u}) {
+		std::bernoulli_distribution coin(4.0 / num_qubits);
+		LinearPP<Parity> parities;
+		for (uint32_t i = 0u; i < 2u * num_qubits; ++i) {
+			Parity parity(num_qubits);
+			for (uint32_t j = 0u; j < num_qubits; ++j) {
+				parity.set(j, coin(gen));
+			}
+			if (parity.none()) {
+				continue;
+			}
+			parities.add_term(parity, angle_dist(gen));
+		}
+		CHECK(implements(
+		    gray_synth(num_qubits, parities), num_qubits, parities));
+	}
+}
+
+TEST_CASE("Gray synthesis of dense phase polynomials", "[gray_synth][synth]")
+{
+	std::mt19937 gen(5u);
+	std::uniform_real_distribution<double> angle_dist(-M_PI, M_PI);
+	uint32_t const num_qubits = 14u;
+	LinearPP<uint32_t> parities;
+	for (uint32_t i = 0u; i < 10000u; ++i) {
+		uint32_t const parity = gen() & ((1u << num_qubits) - 1u);
+		if (parity != 0u) {
+			parities.add_term(parity, angle_dist(gen));
+		}
+	}
+	CHECK(parities.size() > 5000u);
+	CHECK(implements(
+	    gray_synth(num_qubits, parities), num_qubits, parities));
+}
+
+TEST_CASE("Portfolio gray synthesis", "[gray_synth][synth]")
+{
+	auto const num_cnots = [](Circuit const& circuit) {
+		uint32_t count = 0u;
+		for (auto const& inst : circuit) {
+			count += inst.is<GateLib::X>();
+		}
+		return count;
+	};
+	std::mt19937 gen(11u);
+	std::uniform_real_distribution<double> angle_dist(-M_PI, M_PI);
+	uint32_t const num_qubits = 10u;
+	LinearPP<uint32_t> parities;
+	for (uint32_t i = 0u; i < 4u * num_qubits; ++i) {
+		uint32_t const parity = gen() & ((1u << num_qubits) - 1u);
+		if (parity != 0u) {
+			parities.add_term(parity, angle_dist(gen));
+		}
+	}
+	Circuit const reference = gray_synth(num_qubits, parities);
+	Circuit const best = gray_synth_portfolio(num_qubits, parities, 8u, 3u);
+	CHECK(implements(best, num_qubits, parities));
+	CHECK(num_cnots(best) <= num_cnots(reference));
+	// The result does not depend on the number of threads.
+	Circuit const serial
+	    = gray_synth_portfolio(num_qubits, parities, 8u, 3u, 1u);
+	CHECK(num_cnots(serial) == num_cnots(best));
+	CHECK(serial.size() == best.size());
+}
+
+TEST_CASE("All linear synthesis with bitset parities", "[all_linear][synth]")
+{
+	using Parity = DynamicBitset<uint64_t>;
+	uint32_t const num_qubits = 3u;
+	LinearPP<Parity> wide;
+	LinearPP<uint32_t> narrow;
+	for (uint32_t i = 1u; i < (1u << num_qubits); ++i) {
+		wide.add_term(Parity(num_qubits, i), 0.1 * i);
+		narrow.add_term(i, 0.1 * i);
+	}
+	CHECK(unitary_verify(all_linear_synth(num_qubits, wide),
+	    all_linear_synth(num_qubits, narrow)));
+	CHECK(unitary_verify(gray_synth(num_qubits, wide),
+	    gray_synth(num_qubits, narrow)));
+}
+
+TEST_CASE("Streaming all linear synthesis", "[all_linear][synth]")
+{
+	uint32_t const num_qubits = 6u;
+	LinearPP<uint32_t> parities;
+	for (uint32_t i = 1u; i < (1u << num_qubits); i += 3u) {
+		parities.add_term(i, 0.1 * i);
+	}
+	Circuit const circuit = all_linear_synth(num_qubits, parities);
+	CHECK(implements(circuit, num_qubits, parities));
+
+	// The callbacks see the same gates, in the same order
+	uint32_t num_cnots = 0u;
+	uint32_t num_phases = 0u;
+	bool same_gates = true;
+	auto it = circuit.begin();
+	all_linear_synth(
+	    num_qubits, parities,
+	    [&](uint32_t control, uint32_t target) {
+		    same_gates &= it->is<GateLib::X>();
+		    same_gates &= it->begin()->uid() == control;
+		    same_gates &= it->target().uid() == target;
+		    ++num_cnots;
+		    ++it;
+	    },
+	    [&](uint32_t qubit, double angle) {
+		    same_gates &= it->is<GateLib::R1>();
+		    same_gates &= it->target().uid() == qubit;
+		    same_gates &= it->cast<GateLib::R1>().angle() == angle;
+		    ++num_phases;
+		    ++it;
+	    });
+	CHECK(same_gates);
+	CHECK(it == circuit.end());
+	CHECK(num_cnots == (1u << num_qubits) - 2u);
+	CHECK(num_phases == parities.size());
+}
+
+TEST_CASE("All linear synthesis without qubits", "[all_linear][synth]")
+{
+	// The only term is constant, i.e., a global phase: no gates.
+	LinearPP<uint32_t> parities;
+	parities.add_term(0u, 0.5);
+	uint32_t num_gates = 0u;
+	all_linear_synth(
+	    0u, parities, [&](uint32_t, uint32_t) { ++num_gates; },
+	    [&](uint32_t, double) { ++num_gates; });
+	CHECK(num_gates == 0u);
+}
@@ -0,0 +1,101 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/algorithms/synthesis/spectrum_synth.h"
+
+#include "tweedledum/algorithms/synthesis/diagonal_synth.h"
+#include "tweedledum/algorithms/verification/unitary_verify.h"
+#include "tweedledum/ir/Circuit.h"
+#include "tweedledum/ir/GateLib.h"
+#include "tweedledum/ir/Wire.h"
+
+#include <catch.hpp>
+#include <cmath>
+#include <kitty/kitty.hpp>
+#include <vector>
+
+namespace {
+using namespace tweedledum;
+
+// The oracle as the diagonal (-1)^(f(x) * y) conjugated by Hadamards on y.
+Circuit reference_oracle(kitty::dynamic_truth_table const& function)
+{
+	uint32_t const num_vars = function.num_vars();
+	std::vector<double> angles(2u << num_vars, 0.0);
+	for (uint32_t x = 0u; x < (1u << num_vars); ++x) {
+		if (kitty::get_bit(function, x)) {
+			angles[x | (1u << num_vars)] = M_PI;
+		}
+	}
+	Circuit circuit("reference");
+	std::vector<WireRef> qubits;
+	for (uint32_t i = 0u; i <= num_vars; ++i) {
+		qubits.push_back(circuit.create_qubit());
+	}
+	circuit.create_instruction(GateLib::H(), {qubits.back()});
+	diagonal_synth(circuit, qubits, angles);
+	circuit.create_instruction(GateLib::H(), {qubits.back()});
+	return circuit;
+}
+
+} // namespace
+
+TEST_CASE("Spectrum synthesis", "[spectrum][synth]")
+{
+	for (uint32_t num_vars = 1u; num_vars <= 3u; ++num_vars) {
+		uint32_t const num_functions = 1u << (1u << num_vars);
+		for (uint32_t bits = 0u; bits < num_functions; bits += 3u) {
+			kitty::dynamic_truth_table function(num_vars);
+			kitty::create_from_words(function, &bits, &bits + 1);
+			CHECK(unitary_verify(
+			    spectrum_synth(function), reference_oracle(function)));
+		}
+	}
+}
+
+TEST_CASE("Spectrum of the oracle phase function", "[spectrum][synth]")
+{
+	using namespace spectrum_synth_detail;
+	for (uint32_t num_vars = 1u; num_vars <= 9u; ++num_vars) {
+		kitty::dynamic_truth_table function(num_vars);
+		kitty::create_random(function, num_vars);
+		// Reference: the spectrum of f(x) * y, computed by kitty
+		auto extended = kitty::extend_to(function, num_vars + 1);
+		auto y = extended.construct();
+		kitty::create_nth_var(y, num_vars);
+		extended &= y;
+		auto const expected = kitty::rademacher_walsh_spectrum(extended);
+
+		auto const spectrum = spectrum_synth_detail::spectrum(function);
+		REQUIRE(spectrum.size() == (1u << num_vars));
+		bool same = true;
+		for (uint32_t i = 0u; i < expected.size(); ++i) {
+			uint32_t const w = i & (spectrum.size() - 1u);
+			bool const b = (i >> num_vars) & 1u;
+			same &= (oracle_coefficient(spectrum, w, b) == expected[i]);
+		}
+		CHECK(same);
+	}
+}
+
+TEST_CASE("Approximate spectrum synthesis", "[spectrum][synth]")
+{
+	kitty::dynamic_truth_table function(3u);
+	kitty::create_majority(function);
+	Circuit exact("exact");
+	Circuit approx("approx");
+	std::vector<WireRef> exact_qubits;
+	std::vector<WireRef> approx_qubits;
+	for (uint32_t i = 0u; i <= 3u; ++i) {
+		exact_qubits.push_back(exact.create_qubit());
+		approx_qubits.push_back(approx.create_qubit());
+	}
+	CHECK(spectrum_synth(exact, exact_qubits, function) == 0.0);
+	// Every coefficient is at most pi / 2 in magnitude
+	double const error
+	    = spectrum_synth(approx, approx_qubits, function, M_PI_2);
+	CHECK(error == 2.0);
+	CHECK(approx.size() == 2u);
+	CHECK(approx.size() < exact.size());
+}
@@ -0,0 +1,123 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/algorithms/synthesis/synthesis_cache.h"
+
+#include "tweedledum/algorithms/synthesis/diagonal_synth.h"
+#include "tweedledum/algorithms/synthesis/spectrum_synth.h"
+#include "tweedledum/algorithms/verification/unitary_verify.h"
+#include "tweedledum/ir/Circuit.h"
+#include "tweedledum/ir/Wire.h"
+
+#include <catch.hpp>
+#include <cmath>
+#include <kitty/kitty.hpp>
+#include <vector>
+
+namespace {
+using namespace tweedledum;
+
+bool same_gates(Circuit const& circuit0, Circuit const& circuit1)
+{
+	if (circuit0.size() != circuit1.size()) {
+		return false;
+	}
+	auto it = circuit1.begin();
+	for (Instruction const& inst : circuit0) {
+		if (inst.kind() != it->kind()
+		    || !std::equal(inst.begin(), inst.end(), it->begin(), it->end())) {
+			return false;
+		}
+		++it;
+	}
+	return true;
+}
+
+// Creates `num_qubits` qubits and returns them in reverse order, complementing
+// those selected by `mask`.
+std::vector<WireRef> create_qubits(
+    Circuit& circuit, uint32_t num_qubits, uint32_t mask = 0u)
+{
+	std::vector<WireRef> qubits;
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		qubits.insert(qubits.begin(), circuit.create_qubit());
+	}
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		if ((mask >> i) & 1u) {
+			qubits[i].complement();
+		}
+	}
+	return qubits;
+}
+
+} // namespace
+
+TEST_CASE("Cached diagonal synthesis", "[diagonal][synth][cache]")
+{
+	using namespace tweedledum;
+	std::vector<double> const angles
+	    = {0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8};
+	SynthesisCache cache;
+	for (uint32_t mask : {0u, 0u, 5u, 5u, 0u}) {
+		Circuit expected("expected");
+		std::vector<WireRef> qubits = create_qubits(expected, 3u, mask);
+		double const expected_error
+		    = diagonal_synth(expected, qubits, angles, 0.15);
+
+		Circuit cached("cached");
+		qubits = create_qubits(cached, 3u, mask);
+		CHECK(cache.diagonal_synth(cached, qubits, angles, 0.15)
+		      == expected_error);
+		CHECK(same_gates(cached, expected));
+		CHECK(unitary_verify(cached, expected));
+	}
+	CHECK(cache.stats().misses == 2u);
+	CHECK(cache.stats().hits == 3u);
+	CHECK(cache.size() == 2u);
+
+	// A different threshold is a different request
+	Circuit circuit("circuit");
+	cache.diagonal_synth(circuit, create_qubits(circuit, 3u), angles);
+	CHECK(cache.stats().misses == 3u);
+	cache.clear();
+	CHECK(cache.size() == 0u);
+	CHECK(cache.stats().hits == 0u);
+}
+
+TEST_CASE("Cached spectrum synthesis", "[spectrum][synth][cache]")
+{
+	using namespace tweedledum;
+	SynthesisCache cache(4u);
+	for (uint32_t round = 0u; round < 2u; ++round) {
+		for (uint32_t bits = 0u; bits < 16u; bits += 3u) {
+			kitty::dynamic_truth_table function(2u);
+			kitty::create_from_words(function, &bits, &bits + 1);
+			Circuit expected("expected");
+			std::vector<WireRef> qubits = create_qubits(expected, 4u);
+			qubits.pop_back();
+			spectrum_synth(expected, qubits, function);
+
+			Circuit cached("cached");
+			qubits = create_qubits(cached, 4u);
+			qubits.pop_back();
+			cache.spectrum_synth(cached, qubits, function);
+			CHECK(same_gates(cached, expected));
+		}
+	}
+	// Six functions cycle through four entries: nothing is ever reused.
+	CHECK(cache.stats().hits == 0u);
+	CHECK(cache.stats().misses == 12u);
+	CHECK(cache.stats().evictions == 8u);
+
+	// The same truth table words on a different number of variables
+	kitty::dynamic_truth_table function(3u);
+	kitty::create_from_hex_string(function, "0f");
+	kitty::dynamic_truth_table other(4u);
+	kitty::create_from_hex_string(other, "000f");
+	Circuit circuit("circuit");
+	cache.spectrum_synth(circuit, create_qubits(circuit, 4u), function);
+	cache.spectrum_synth(circuit, create_qubits(circuit, 5u), other);
+	cache.spectrum_synth(circuit, create_qubits(circuit, 4u), function);
+	CHECK(cache.stats().hits == 1u);
+}
@@ -2,16 +2,13 @@
 | Part of tweedledum.  This file is distributed under the MIT License.
 | See accompanying file /LICENSE for details.
 *-----------------------------------------------------------------------------*/
-// FIXME: There are conflicts among SAT solvers, so this header need to appear
-//        first! Quite weird!
-#include <mockturtle/algorithms/equivalence_checking.hpp>
 #include "tweedledum/algorithms/synthesis/xag/xag_synth.h"
 
+#include "tweedledum/algorithms/verification/xag_verify.h"
 #include "tweedledum/ir/Circuit.h"
 #include "tweedledum/ir/Wire.h"
 
 #include <catch.hpp>
-#include <mockturtle/algorithms/miter.hpp>
 #include <mockturtle/algorithms/xag_optimization.hpp>
 #include <mockturtle/generators/arithmetic.hpp>
 #include <mockturtle/generators/control.hpp>
@@ -19,39 +16,6 @@
 #include <mockturtle/networks/xag.hpp>
 #include <vector>
 
-// Helper function
-namespace tweedledum {
-
-mockturtle::xag_network to_xag_network(
-    Circuit const& circuit, uint32_t num_i, uint32_t num_o)
-{
-	using Signal = typename mockturtle::xag_network::signal;
-
-	auto network = mockturtle::xag_network();
-	std::vector<Signal> to_signal(
-	    circuit.num_qubits(), network.get_constant(false));
-	for (uint32_t i = 0; i < num_i; ++i) {
-		to_signal[i] = network.create_pi();
-	}
-	for (Instruction const& inst : circuit) {
-		std::vector<Signal> signals;
-		for (WireRef w : inst) {
-			signals.push_back(to_signal[w.uid()] ^ w.is_complemented());
-		}
-		if (inst.is<GateLib::Parity>()) {
-			to_signal[inst.target().uid()] = network.create_nary_xor(signals);
-			continue;
-		}
-		Signal const ctrl = network.create_nary_and({signals.begin(), signals.end() - 1});
-		to_signal[inst.target().uid()] = network.create_xor(signals.back(), ctrl);
-	}
-	for (uint32_t i = 0; i < num_o; ++i) {
-		network.create_po(to_signal[num_i + i]);
-	}
-	return network;
-}
-} // namespace tweedledum
-
 TEST_CASE("Synthesize constant gate", "[xag][synth]")
 {
 	using namespace tweedledum;
@@ -61,9 +25,7 @@ TEST_CASE("Synthesize constant gate", "[xag][synth]")
 		oracle.create_po(oracle.get_constant(false));
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -74,9 +36,7 @@ TEST_CASE("Synthesize constant gate", "[xag][synth]")
 		oracle.create_po(oracle.get_constant(false));
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -86,9 +46,7 @@ TEST_CASE("Synthesize constant gate", "[xag][synth]")
 		oracle.create_po(oracle.get_constant(true));
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -99,9 +57,7 @@ TEST_CASE("Synthesize constant gate", "[xag][synth]")
 		oracle.create_po(oracle.get_constant(true));
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -114,9 +70,7 @@ TEST_CASE("Synthesize constant gate", "[xag][synth]")
 		oracle.create_po(oracle.get_constant(false));
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -132,9 +86,7 @@ TEST_CASE("Synthesize buffer gate", "[xag][synth]")
 		oracle.create_po(a);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -145,9 +97,7 @@ TEST_CASE("Synthesize buffer gate", "[xag][synth]")
 		oracle.create_po(a ^ 1);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -159,9 +109,7 @@ TEST_CASE("Synthesize buffer gate", "[xag][synth]")
 		oracle.create_po(a);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -179,9 +127,7 @@ TEST_CASE("Synthesize one AND gate", "[xag][synth]")
 		oracle.create_po(ab);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -194,9 +140,7 @@ TEST_CASE("Synthesize one AND gate", "[xag][synth]")
 		oracle.create_po(ab ^ 1);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -209,9 +153,7 @@ TEST_CASE("Synthesize one AND gate", "[xag][synth]")
 		oracle.create_po(ab);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -224,9 +166,7 @@ TEST_CASE("Synthesize one AND gate", "[xag][synth]")
 		oracle.create_po(ab);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -239,9 +179,7 @@ TEST_CASE("Synthesize one AND gate", "[xag][synth]")
 		oracle.create_po(ab);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -254,9 +192,7 @@ TEST_CASE("Synthesize one AND gate", "[xag][synth]")
 		oracle.create_po(ab ^ 1);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -270,9 +206,7 @@ TEST_CASE("Synthesize one AND gate", "[xag][synth]")
 		oracle.create_po(ab);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -286,9 +220,7 @@ TEST_CASE("Synthesize one AND gate", "[xag][synth]")
 		oracle.create_po(ab);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -302,9 +234,7 @@ TEST_CASE("Synthesize one AND gate", "[xag][synth]")
 		oracle.create_po(ab ^ 1);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -322,9 +252,7 @@ TEST_CASE("Synthesize one XOR gate", "[xag][synth]")
 		oracle.create_po(a_xor_b);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -337,9 +265,7 @@ TEST_CASE("Synthesize one XOR gate", "[xag][synth]")
 		oracle.create_po(a_xor_b ^ 1);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -353,9 +279,7 @@ TEST_CASE("Synthesize one XOR gate", "[xag][synth]")
 		oracle.create_po(a_xor_b);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -369,9 +293,7 @@ TEST_CASE("Synthesize one XOR gate", "[xag][synth]")
 		oracle.create_po(a_xor_b);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -385,9 +307,7 @@ TEST_CASE("Synthesize one XOR gate", "[xag][synth]")
 		oracle.create_po(a_xor_b ^ 1);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -406,9 +326,7 @@ TEST_CASE("Synthesize AND-XOR gate", "[xag][synth]")
 		oracle.create_po(ab_xor_b);
 
 		Circuit circuit = xag_synth(oracle);
-		auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-		auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, oracle);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -442,9 +360,7 @@ TEST_CASE("An edge case", "[xag][synth]")
 	oracle.create_po(n30);
 
 	Circuit circuit = xag_synth(oracle);
-	auto xag = to_xag_network(circuit, oracle.num_pis(), oracle.num_pos());
-	auto const miter = *mockturtle::miter<mockturtle::xag_network>(oracle, xag);
-	auto const result = mockturtle::equivalence_checking(miter);
+	auto const result = xag_verify(circuit, oracle);
 	CHECK(result);
 	CHECK(*result);
 }
@@ -471,9 +387,7 @@ TEST_CASE("Out-of-place adder", "[xag][synth]")
 		xag.create_po(carry);
 
 		Circuit circuit = xag_synth(xag);
-		auto output = to_xag_network(circuit, xag.num_pis(), xag.num_pos());
-		auto const miter = *mockturtle::miter<xag_network>(xag, output);
-		auto const result = equivalence_checking(miter);
+		auto const result = xag_verify(circuit, xag);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -499,9 +413,7 @@ TEST_CASE("Out-of-place modular adder", "[xag][synth]")
 		});
 
 		Circuit circuit = xag_synth(xag);
-		auto output = to_xag_network(circuit, xag.num_pis(), xag.num_pos());
-		auto const miter = *mockturtle::miter<xag_network>(xag, output);
-		auto const result = equivalence_checking(miter);
+		auto const result = xag_verify(circuit, xag);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -527,9 +439,7 @@ TEST_CASE("Out-of-place multiplier", "[xag][synth]")
 		xag = xag_constant_fanin_optimization(xag);
 
 		Circuit circuit = xag_synth(xag);
-		auto output = to_xag_network(circuit, xag.num_pis(), xag.num_pos());
-		auto const miter = *mockturtle::miter<xag_network>(xag, output);
-		auto const result = mockturtle::equivalence_checking(miter);
+		auto const result = xag_verify(circuit, xag);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -555,9 +465,7 @@ TEST_CASE("Out-of-place Montgomery multiplier", "[xag][synth]")
 	xag = xag_constant_fanin_optimization(xag);
 
 	Circuit circuit = xag_synth(xag);
-	auto output = to_xag_network(circuit, xag.num_pis(), xag.num_pos());
-	auto const miter = *mockturtle::miter<xag_network>(xag, output);
-	auto const result = equivalence_checking(miter);
+	auto const result = xag_verify(circuit, xag);
 	CHECK(result);
 	CHECK(*result);
 }
@@ -579,9 +487,7 @@ TEST_CASE("Out-of-place n-to-2^n binary decoder", "[xag][synth]")
 		xag = xag_constant_fanin_optimization(xag);
 
 		Circuit circuit = xag_synth(xag);
-		auto output = to_xag_network(circuit, xag.num_pis(), xag.num_pos());
-		auto const miter = *mockturtle::miter<xag_network>(xag, output);
-		auto const result = equivalence_checking(miter);
+		auto const result = xag_verify(circuit, xag);
 		CHECK(result);
 		CHECK(*result);
 	}
@@ -0,0 +1,184 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/algorithms/verification/phase_poly_verify.h"
+
+#include "tweedledum/algorithms/simulation/circuit_to_phase_poly.h"
+#include "tweedledum/algorithms/synthesis/gray_synth.h"
+#include "tweedledum/algorithms/verification/unitary_verify.h"
+#include "tweedledum/ir/Circuit.h"
+#include "tweedledum/ir/GateLib.h"
+#include "tweedledum/ir/Wire.h"
+#include "tweedledum/support/LinearPP.h"
+
+#include <catch.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+using namespace tweedledum;
+
+// Synthesizes each term on its own: compute the parity on one qubit using a
+// ladder of CNOTs, rotate, and uncompute.
+inline Circuit naive_synth(uint32_t num_qubits, LinearPP<uint32_t> const& terms)
+{
+	Circuit circuit("naive");
+	std::vector<WireRef> qubits;
+	for (uint32_t i = 0u; i < num_qubits; ++i) {
+		qubits.push_back(circuit.create_qubit());
+	}
+	for (auto const& [parity, angle] : terms) {
+		uint32_t const target = 31u - __builtin_clz(parity);
+		std::vector<uint32_t> controls;
+		for (uint32_t i = 0u; i < target; ++i) {
+			if ((parity >> i) & 1u) {
+				controls.push_back(i);
+			}
+		}
+		for (uint32_t control : controls) {
+			circuit.create_instruction(
+			    GateLib::X(), {qubits[control]}, qubits[target]);
+		}
+		circuit.create_instruction(GateLib::R1(angle), {qubits[target]});
+		for (uint32_t control : controls) {
+			circuit.create_instruction(
+			    GateLib::X(), {qubits[control]}, qubits[target]);
+		}
+	}
+	return circuit;
+}
+
+} // namespace
+
+TEST_CASE("Extract phase polynomials", "[phase_poly][verify]")
+{
+	using namespace tweedledum;
+	SECTION("Complemented rotation")
+	{
+		Circuit circuit("circuit");
+		WireRef q0 = circuit.create_qubit();
+		WireRef q1 = circuit.create_qubit();
+		circuit.create_instruction(GateLib::X(), {q0});
+		circuit.create_instruction(GateLib::X(), {q0}, q1);
+		circuit.create_instruction(GateLib::R1(0.5), {q1});
+		auto const form = circuit_to_phase_poly(circuit);
+		using Parity = PhasePolynomial::Parity;
+		REQUIRE(form);
+		CHECK(form->terms.size() == 1u);
+		CHECK(form->terms.begin()->first == Parity(2, uint64_t(3)));
+		CHECK(form->terms.begin()->second == -0.5);
+		CHECK(form->global_phase == 0.5);
+		CHECK(form->complemented == Parity(2, uint64_t(3)));
+		CHECK(form->linear_trans[0] == Parity(2, uint64_t(1)));
+		CHECK(form->linear_trans[1] == Parity(2, uint64_t(3)));
+	}
+	SECTION("Not CNOT-dihedral")
+	{
+		Circuit circuit("circuit");
+		WireRef q0 = circuit.create_qubit();
+		circuit.create_instruction(GateLib::H(), {q0});
+		CHECK_FALSE(circuit_to_phase_poly(circuit));
+		CHECK_FALSE(phase_poly_verify(circuit, circuit));
+	}
+}
+
+TEST_CASE("Verify CNOT-dihedral circuits", "[phase_poly][verify]")
+{
+	using namespace tweedledum;
+	std::mt19937 gen(42u);
+	std::uniform_real_distribution<double> angle_dist(-M_PI, M_PI);
+	SECTION("Gray synthesis")
+	{
+		uint32_t const num_qubits = 4u;
+		std::uniform_int_distribution<uint32_t> parity_dist(
+		    1u, (1u << num_qubits) - 1u);
+		for (uint32_t i = 0u; i < 16u; ++i) {
+			LinearPP<uint32_t> terms;
+			for (uint32_t j = 0u; j < 6u; ++j) {
+				terms.add_term(parity_dist(gen), angle_dist(gen));
+			}
+			Circuit const expected = naive_synth(num_qubits, terms);
+			Circuit const circuit = gray_synth(num_qubits, terms);
+			CHECK(unitary_verify(circuit, expected));
+			auto const result = phase_poly_verify(circuit, expected);
+			REQUIRE(result);
+			CHECK(*result);
+		}
+	}
+	SECTION("Random wide circuits")
+	{
+		uint32_t const num_qubits = 200u;
+		Circuit circuit0("circuit0");
+		Circuit circuit1("circuit1");
+		std::vector<WireRef> qubits0;
+		std::vector<WireRef> qubits1;
+		for (uint32_t i = 0u; i < num_qubits; ++i) {
+			qubits0.push_back(circuit0.create_qubit());
+			qubits1.push_back(circuit1.create_qubit());
+		}
+		std::uniform_int_distribution<uint32_t> qubit_dist(
+		    0u, num_qubits - 1u);
+		std::uniform_int_distribution<uint32_t> gate_dist(0u, 9u);
+		for (uint32_t i = 0u; i < 5000u; ++i) {
+			uint32_t const target = qubit_dist(gen);
+			uint32_t control = qubit_dist(gen);
+			while (control == target) {
+				control = qubit_dist(gen);
+			}
+			switch (gate_dist(gen)) {
+			case 0:
+				circuit0.create_instruction(
+				    GateLib::X(), {qubits0[target]});
+				circuit1.create_instruction(
+				    GateLib::X(), {qubits1[target]});
+				break;
+
+			case 1:
+			case 2: {
+				double const angle = angle_dist(gen);
+				circuit0.create_instruction(
+				    GateLib::R1(angle), {qubits0[target]});
+				circuit1.create_instruction(
+				    GateLib::R1(angle), {qubits1[target]});
+			} break;
+
+			case 3:
+				// Insert a pair of CNOTs that cancel out.
+				circuit1.create_instruction(GateLib::X(),
+				    {qubits1[control]}, qubits1[target]);
+				circuit1.create_instruction(GateLib::X(),
+				    {qubits1[control]}, qubits1[target]);
+				break;
+
+			default:
+				circuit0.create_instruction(GateLib::X(),
+				    {qubits0[control]}, qubits0[target]);
+				circuit1.create_instruction(GateLib::X(),
+				    {qubits1[control]}, qubits1[target]);
+				break;
+			}
+		}
+		auto result = phase_poly_verify(circuit0, circuit1);
+		REQUIRE(result);
+		CHECK(*result);
+
+		// A full turn does not change anything
+		circuit1.create_instruction(GateLib::R1(2 * M_PI), {qubits1[0]});
+		result = phase_poly_verify(circuit0, circuit1);
+		REQUIRE(result);
+		CHECK(*result);
+
+		circuit1.create_instruction(GateLib::R1(1e-3), {qubits1[0]});
+		result = phase_poly_verify(circuit0, circuit1);
+		REQUIRE(result);
+		CHECK_FALSE(*result);
+
+		circuit0.create_instruction(GateLib::R1(1e-3), {qubits0[0]});
+		circuit0.create_instruction(
+		    GateLib::X(), {qubits0[1]}, qubits0[0]);
+		result = phase_poly_verify(circuit0, circuit1);
+		REQUIRE(result);
+		CHECK_FALSE(*result);
+	}
+}
@@ -0,0 +1,140 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/algorithms/verification/xag_verify.h"
+#include "tweedledum/algorithms/verification/xag_random_verify.h"
+
+#include "tweedledum/algorithms/simulation/simulate_classically.h"
+#include "tweedledum/algorithms/synthesis/xag/xag_synth.h"
+#include "tweedledum/ir/Circuit.h"
+#include "tweedledum/ir/GateLib.h"
+#include "tweedledum/ir/Wire.h"
+#include "tweedledum/support/DynamicBitset.h"
+
+#include <catch.hpp>
+#include <mockturtle/algorithms/simulation.hpp>
+#include <mockturtle/generators/arithmetic.hpp>
+#include <mockturtle/networks/xag.hpp>
+#include <vector>
+
+TEST_CASE("Verify circuits against XAGs", "[xag][verify]")
+{
+	using namespace mockturtle;
+	using namespace tweedledum;
+	SECTION("Wide adder")
+	{
+		uint32_t const n = 64;
+		xag_network xag;
+		std::vector<xag_network::signal> a(n);
+		std::vector<xag_network::signal> b(n);
+		std::generate(a.begin(), a.end(), [&xag]() {
+			return xag.create_pi();
+		});
+		std::generate(b.begin(), b.end(), [&xag]() {
+			return xag.create_pi();
+		});
+		auto carry = xag.create_pi();
+		carry_ripple_adder_inplace(xag, a, b, carry);
+		std::for_each(a.begin(), a.end(), [&](auto f) {
+			xag.create_po(f);
+		});
+		xag.create_po(carry);
+
+		Circuit circuit = xag_synth(xag);
+		auto const result = xag_verify(circuit, xag);
+		CHECK(result);
+		CHECK(*result);
+	}
+	SECTION("Counterexample")
+	{
+		xag_network xag;
+		auto a = xag.create_pi();
+		auto b = xag.create_pi();
+		auto c = xag.create_pi();
+		xag.create_po(xag.create_and(xag.create_xor(a, b), c));
+
+		Circuit circuit = xag_synth(xag);
+		// Break the circuit for a = 1, b = 0, c = 1.
+		std::vector<WireRef> qubits;
+		std::for_each(circuit.begin_wire(), circuit.end_wire(),
+		[&](Wire const& wire) {
+			qubits.push_back(circuit.wire_ref(wire));
+		});
+		circuit.create_instruction(
+		    GateLib::X(), {qubits[0], !qubits[1], qubits[2]}, qubits[3]);
+
+		std::vector<bool> counter_example;
+		auto const result = xag_verify(circuit, xag, &counter_example);
+		CHECK(result);
+		CHECK_FALSE(*result);
+		REQUIRE(counter_example.size() == 3u);
+		CHECK(counter_example == std::vector<bool>({true, false, true}));
+
+		// The counterexample must be a real mismatch
+		DynamicBitset<uint64_t> pattern(circuit.num_qubits());
+		for (uint32_t i = 0u; i < counter_example.size(); ++i) {
+			pattern.set(i, counter_example[i]);
+		}
+		auto const sim_pattern = simulate_classically(circuit, pattern);
+		default_simulator<bool> sim(counter_example);
+		CHECK(simulate<bool>(xag, sim)[0] != sim_pattern[3]);
+	}
+	SECTION("Counterexample for a rare mismatch")
+	{
+		uint32_t const n = 24;
+		xag_network xag;
+		std::vector<xag_network::signal> xs(n);
+		std::generate(xs.begin(), xs.end(), [&xag]() {
+			return xag.create_pi();
+		});
+		xag.create_po(xag.create_nary_xor(xs));
+
+		Circuit circuit = xag_synth(xag);
+		std::vector<WireRef> qubits;
+		std::for_each(circuit.begin_wire(), circuit.end_wire(),
+		[&](Wire const& wire) {
+			qubits.push_back(circuit.wire_ref(wire));
+		});
+		CHECK_FALSE(xag_random_verify(circuit, qubits, xag));
+		auto const result = xag_verify(circuit, xag);
+		CHECK(result);
+		CHECK(*result);
+
+		// Only the all-ones assignment is wrong, random patterns are
+		// unlikely to find it but the SAT solver must.
+		std::vector<WireRef> controls(qubits.begin(), qubits.begin() + n);
+		circuit.create_instruction(GateLib::X(), controls, qubits[n]);
+		std::vector<bool> counter_example;
+		auto const broken = xag_verify(circuit, xag, &counter_example);
+		CHECK(broken);
+		CHECK_FALSE(*broken);
+		CHECK(counter_example == std::vector<bool>(n, true));
+	}
+}
+
+TEST_CASE("Random simulation screen against XAGs", "[xag][verify]")
+{
+	using namespace mockturtle;
+	using namespace tweedledum;
+	xag_network xag;
+	auto a = xag.create_pi();
+	auto b = xag.create_pi();
+	auto c = xag.create_pi();
+	xag.create_po(xag.create_and(a, b));
+	xag.create_po(xag.create_xor(b, c) ^ 1);
+
+	Circuit circuit = xag_synth(xag);
+	std::vector<WireRef> qubits;
+	std::for_each(circuit.begin_wire(), circuit.end_wire(),
+	[&](Wire const& wire) {
+		qubits.push_back(circuit.wire_ref(wire));
+	});
+	CHECK_FALSE(xag_random_verify(circuit, qubits, xag));
+
+	circuit.create_instruction(GateLib::X(), {qubits[2]}, qubits[3]);
+	auto const mismatch = xag_random_verify(circuit, qubits, xag);
+	REQUIRE(mismatch);
+	CHECK(mismatch->size() == 3u);
+	CHECK(mismatch->at(2));
+}
@@ -34,3 +34,41 @@ TEST_CASE("Basic unitary functionality", "[unitary][ir]")
 		CHECK(u.num_qubits() == 1u);
 	}
 }
+
+TEST_CASE("Unitary comparison", "[unitary][ir]")
+{
+	using namespace tweedledum;
+	SECTION("Negative controls")
+	{
+		Unitary u0("unitary_0");
+		WireRef q0 = u0.create_qubit();
+		WireRef q1 = u0.create_qubit();
+		u0.create_instruction(GateLib::X(), {!q0}, q1);
+
+		Unitary u1("unitary_1");
+		u1.create_qubit();
+		u1.create_qubit();
+		u1.create_instruction(GateLib::X(), {q0}, q1);
+		CHECK_FALSE(is_approx_equal(u0, u1));
+
+		// Flipping q1 when q0 is 0 is flipping it when q0 is 1, then
+		// flipping it unconditionally.
+		u1.create_instruction(GateLib::X(), {q1});
+		CHECK(is_approx_equal(u0, u1));
+	}
+	SECTION("Global phase")
+	{
+		// X R1(a) X == e^(ia) R1(-a)
+		Unitary u0("unitary_0");
+		WireRef q0 = u0.create_qubit();
+		u0.create_instruction(GateLib::X(), {q0});
+		u0.create_instruction(GateLib::R1(0.3), {q0});
+		u0.create_instruction(GateLib::X(), {q0});
+
+		Unitary u1("unitary_1");
+		u1.create_qubit();
+		u1.create_instruction(GateLib::R1(-0.3), {q0});
+		CHECK_FALSE(is_approx_equal(u0, u1));
+		CHECK(is_approx_equal(u0, u1, 1e-05, 1e-08, true));
+	}
+}
@@ -0,0 +1,95 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/support/BitOps.h"
+#include "tweedledum/support/BitMatrix.h"
+#include "tweedledum/support/DynamicBitset.h"
+
+#include <catch.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace tweedledum;
+
+TEST_CASE("Bulk word operations agree with scalar code", "[bit_ops]")
+{
+	std::mt19937_64 gen(17);
+	SimdIsa const isa = GENERATE(SimdIsa::avx2, SimdIsa::avx512);
+	// Sizes around the vector widths and the dispatch threshold
+	std::size_t const n = GENERATE(0u, 1u, 3u, 4u, 7u, 8u, 9u, 15u, 16u,
+	    17u, 31u, 64u, 257u, 1000u);
+	std::vector<uint64_t> a(n);
+	std::vector<uint64_t> b(n);
+	for (std::size_t i = 0u; i < n; ++i) {
+		a[i] = gen();
+		b[i] = gen();
+	}
+	std::vector<uint64_t> ones(n, ~uint64_t(0));
+	std::vector<uint64_t> zeros(n, 0u);
+
+	set_simd_isa(SimdIsa::scalar);
+	std::vector<uint64_t> x_xor = a;
+	std::vector<uint64_t> x_and = a;
+	std::vector<uint64_t> x_or = a;
+	words_xor(x_xor.data(), b.data(), n);
+	words_and(x_and.data(), b.data(), n);
+	words_or(x_or.data(), b.data(), n);
+	std::size_t const count = words_popcount(a.data(), n);
+
+	set_simd_isa(isa);
+	std::vector<uint64_t> y_xor = a;
+	std::vector<uint64_t> y_and = a;
+	std::vector<uint64_t> y_or = a;
+	words_xor(y_xor.data(), b.data(), n);
+	words_and(y_and.data(), b.data(), n);
+	words_or(y_or.data(), b.data(), n);
+	CHECK(y_xor == x_xor);
+	CHECK(y_and == x_and);
+	CHECK(y_or == x_or);
+	CHECK(words_popcount(a.data(), n) == count);
+	CHECK(words_popcount(ones.data(), n) == 64u * n);
+	CHECK(words_any(zeros.data(), n) == false);
+	CHECK(words_all(ones.data(), n) == true);
+	if (n > 0u) {
+		// A single bit at the very end must be noticed
+		zeros.back() = uint64_t(1) << 63;
+		ones.back() = ~(uint64_t(1) << 63);
+		CHECK(words_any(zeros.data(), n) == true);
+		CHECK(words_all(ones.data(), n) == false);
+	}
+	set_simd_isa(simd_isa_supported());
+}
+
+TEST_CASE("Bitsets and bit matrices use the bulk operations", "[bit_ops]")
+{
+	std::mt19937_64 gen(3);
+	uint32_t const num_bits = 1000u;
+	DynamicBitset<uint64_t> a(num_bits);
+	DynamicBitset<uint64_t> b(num_bits);
+	for (uint32_t i = 0u; i < num_bits; ++i) {
+		a.set(i, gen() & 1);
+		b.set(i, gen() & 1);
+	}
+	uint32_t expected = 0u;
+	for (uint32_t i = 0u; i < num_bits; ++i) {
+		expected += a[i] != b[i];
+	}
+	CHECK(a.count() + b.count() > 0u);
+	DynamicBitset<uint64_t> c = a;
+	c ^= b;
+	CHECK(c.count() == expected);
+	c ^= c;
+	CHECK(c.none());
+	c.set();
+	CHECK(c.all());
+	c.reset(0);
+	CHECK_FALSE(c.all());
+
+	BitMatrix matrix(2u, num_bits);
+	std::copy_n(a.data(), matrix.row_words(), matrix.row_data(0));
+	std::copy_n(b.data(), matrix.row_words(), matrix.row_data(1));
+	matrix.row_xor(0, 1);
+	CHECK(matrix.row_weight(0) == expected);
+}
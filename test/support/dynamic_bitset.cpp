@@ -0,0 +1,128 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/support/DynamicBitset.h"
+#include "tweedledum/support/SmallVector.h"
+
+#include <catch.hpp>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+using Bitset = tweedledum::DynamicBitset<uint64_t>;
+
+inline Bitset random_bitset(uint32_t num_bits, std::mt19937& gen)
+{
+	std::bernoulli_distribution coin(0.3);
+	Bitset bitset(num_bits);
+	for (uint32_t i = 0u; i < num_bits; ++i) {
+		bitset.set(i, coin(gen));
+	}
+	return bitset;
+}
+
+} // namespace
+
+TEST_CASE("Word-level bitset operations", "[dynamic_bitset]")
+{
+	std::mt19937 gen(5u);
+	SECTION("Count")
+	{
+		Bitset bitset(130u, true);
+		CHECK(bitset.count() == 130u);
+		bitset.reset(63u);
+		CHECK(bitset.count() == 129u);
+	}
+	SECTION("Find set bits")
+	{
+		Bitset bitset(200u);
+		CHECK(bitset.find_first() == Bitset::npos);
+		std::vector<uint32_t> const positions = {3u, 63u, 64u, 130u, 199u};
+		for (uint32_t i : positions) {
+			bitset.set(i);
+		}
+		std::vector<uint32_t> found;
+		for (auto i = bitset.find_first(); i != Bitset::npos;
+		     i = bitset.find_next(i)) {
+			found.push_back(i);
+		}
+		CHECK(found == positions);
+		found.clear();
+		bitset.foreach_set_bit([&](uint32_t i) {
+			found.push_back(i);
+		});
+		CHECK(found == positions);
+	}
+	SECTION("Shifts and rotations")
+	{
+		for (uint32_t num_bits : {1u, 7u, 64u, 65u, 200u}) {
+			Bitset const bitset = random_bitset(num_bits, gen);
+			for (uint32_t shift : {0u, 1u, 5u, 63u, 64u, 70u, 199u}) {
+				Bitset const left = bitset << shift;
+				Bitset const right = bitset >> shift;
+				Bitset rotated = bitset;
+				rotated.rotate_left(shift);
+				bool all_equal = true;
+				for (uint32_t i = 0u; i < num_bits; ++i) {
+					all_equal &= left[i]
+					             == (i >= shift && bitset[i - shift]);
+					all_equal &= right[i]
+					             == (i + shift < num_bits
+					                 && bitset[i + shift]);
+					uint32_t const from
+					    = (i + num_bits - (shift % num_bits))
+					      % num_bits;
+					all_equal &= rotated[i] == bitset[from];
+				}
+				CHECK(all_equal);
+				rotated.rotate_right(shift);
+				CHECK(rotated == bitset);
+			}
+		}
+	}
+}
+
+TEST_CASE("Bitset storage", "[dynamic_bitset]")
+{
+	std::mt19937 gen(9u);
+	SECTION("Copy and move")
+	{
+		for (uint32_t num_bits : {0u, 5u, 128u, 129u, 500u}) {
+			Bitset const bitset = random_bitset(num_bits, gen);
+			Bitset copy(bitset);
+			CHECK(copy == bitset);
+			Bitset moved(std::move(copy));
+			CHECK(moved == bitset);
+			CHECK(copy.empty());
+			// Assign across the inline/heap boundary
+			for (uint32_t other_bits : {3u, 300u}) {
+				Bitset other = random_bitset(other_bits, gen);
+				other = bitset;
+				CHECK(other == bitset);
+				Bitset another = random_bitset(other_bits, gen);
+				another = std::move(other);
+				CHECK(another == bitset);
+				another.flip();
+				CHECK(another.count() == num_bits - bitset.count());
+			}
+		}
+	}
+	SECTION("Inline storage")
+	{
+		tweedledum::SmallVector<uint64_t, 2> blocks(2u, 1u);
+		CHECK(blocks.is_inline());
+		tweedledum::SmallVector<uint64_t, 2> copy = blocks;
+		CHECK(copy.is_inline());
+		copy.resize(3u, 7u);
+		CHECK_FALSE(copy.is_inline());
+		CHECK(copy[0] == 1u);
+		CHECK(copy.back() == 7u);
+		blocks = std::move(copy);
+		CHECK(blocks.size() == 3u);
+		CHECK(copy.is_inline());
+		CHECK(copy.empty());
+	}
+}
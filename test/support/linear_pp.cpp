@@ -0,0 +1,99 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/support/LinearPP.h"
+
+#include "tweedledum/support/DynamicBitset.h"
+
+#include <catch.hpp>
+#include <cstdint>
+
+TEST_CASE("Linear phase polynomials", "[linear_pp]")
+{
+	using namespace tweedledum;
+	SECTION("Accumulate and extract")
+	{
+		LinearPP<uint32_t> parities;
+		parities.add_term(5u, 0.5);
+		parities.add_term(3u, 0.25);
+		parities.add_term(5u, 0.5);
+		CHECK(parities.size() == 2u);
+		CHECK(parities.extract_term(5u) == 1.0);
+		CHECK(parities.extract_term(5u) == 0.0);
+		CHECK(parities.size() == 1u);
+		parities.add_term(5u, 0.5);
+		CHECK(parities.extract_term(3u) == 0.25);
+		CHECK(parities.extract_term(5u) == 0.5);
+		CHECK(parities.size() == 0u);
+	}
+	SECTION("Finalize")
+	{
+		LinearPP<uint32_t> parities;
+		uint32_t const num_terms = 1u << 16;
+		for (uint32_t i = num_terms; i-- > 0u;) {
+			parities.add_term(i, double(i));
+		}
+		bool all_extracted = true;
+		for (uint32_t i = 0u; i < num_terms; i += 2u) {
+			all_extracted &= (parities.extract_term(i) == double(i));
+		}
+		CHECK(all_extracted);
+		parities.finalize();
+		CHECK(parities.size() == num_terms / 2u);
+		uint32_t expected = 1u;
+		bool all_sorted = true;
+		for (auto const& [parity, angle] : parities) {
+			all_sorted &= (parity == expected && angle == expected);
+			expected += 2u;
+		}
+		CHECK(all_sorted);
+		// Extracting after sorting rebuilds the index
+		CHECK(parities.extract_term(7u) == 7.0);
+		CHECK(parities.extract_term(num_terms - 1u) == num_terms - 1u);
+	}
+	SECTION("Index is built on demand")
+	{
+		LinearPP<uint32_t> parities;
+		for (uint32_t i = 8u; i-- > 0u;) {
+			parities.append_term(i, double(i));
+		}
+		CHECK_FALSE(parities.indexed());
+		// Accumulating needs the index, and still merges appended terms
+		parities.add_term(7u, 1.0);
+		CHECK(parities.indexed());
+		CHECK(parities.size() == 8u);
+		parities.append_term(8u, 8.0);
+		parities.add_term(8u, 1.0);
+		CHECK(parities.size() == 9u);
+		parities.finalize();
+		CHECK_FALSE(parities.indexed());
+		uint32_t expected = 0u;
+		bool all_sorted = true;
+		for (auto const& [parity, angle] : parities) {
+			double const expected_angle
+			    = expected + (expected >= 7u ? 1.0 : 0.0);
+			all_sorted &= (parity == expected && angle == expected_angle);
+			++expected;
+		}
+		CHECK(all_sorted);
+		CHECK(parities.extract_term(7u) == 8.0);
+		CHECK(parities.indexed());
+	}
+	SECTION("Bitset parities")
+	{
+		using Parity = DynamicBitset<uint64_t>;
+		LinearPP<Parity> parities;
+		Parity a(100u);
+		Parity b(100u);
+		a.set(99u);
+		b.set(0u);
+		parities.add_term(a, 1.0);
+		parities.add_term(b, 2.0);
+		parities.add_term(a, 1.0);
+		parities.finalize();
+		CHECK(parities.begin()->first == b);
+		CHECK(parities.extract_term(a) == 2.0);
+		CHECK(parities.extract_term(b) == 2.0);
+	}
+}
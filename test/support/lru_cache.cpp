@@ -0,0 +1,49 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/support/LruCache.h"
+
+#include <catch.hpp>
+#include <cstdint>
+#include <string>
+
+TEST_CASE("LRU cache", "[lru_cache]")
+{
+	using namespace tweedledum;
+	SECTION("Evict the least recently used entry")
+	{
+		LruCache<uint32_t, std::string> cache(2u);
+		cache.insert(1u, "one");
+		cache.insert(2u, "two");
+		REQUIRE(cache.find(1u) != nullptr);
+		cache.insert(3u, "three");
+		CHECK(cache.size() == 2u);
+		CHECK(cache.find(2u) == nullptr);
+		CHECK(*cache.find(1u) == "one");
+		CHECK(*cache.find(3u) == "three");
+		CHECK(cache.stats().hits == 3u);
+		CHECK(cache.stats().misses == 1u);
+		CHECK(cache.stats().evictions == 1u);
+	}
+	SECTION("Overwrite an entry")
+	{
+		LruCache<uint32_t, std::string> cache(2u);
+		cache.insert(1u, "one");
+		cache.insert(2u, "two");
+		cache.insert(1u, "uno");
+		cache.insert(3u, "three");
+		CHECK(*cache.find(1u) == "uno");
+		CHECK(cache.find(2u) == nullptr);
+		CHECK(cache.stats().evictions == 1u);
+	}
+	SECTION("Zero capacity")
+	{
+		LruCache<uint32_t, std::string> cache(0u);
+		cache.insert(1u, "one");
+		CHECK(cache.size() == 0u);
+		CHECK(cache.find(1u) == nullptr);
+		cache.clear();
+		CHECK(cache.stats().misses == 0u);
+	}
+}
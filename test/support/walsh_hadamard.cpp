@@ -0,0 +1,110 @@
+/*------------------------------------------------------------------------------
+| Part of tweedledum.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/support/WalshHadamard.h"
+#include "tweedledum/support/BitOps.h"
+
+#include <catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+template<typename T>
+std::vector<T> naive_transform(std::vector<T> const& values)
+{
+	std::vector<T> result(values.size(), T(0));
+	for (uint32_t w = 0u; w < values.size(); ++w) {
+		for (uint32_t x = 0u; x < values.size(); ++x) {
+			bool const odd = __builtin_popcount(w & x) & 1;
+			result[w] += odd ? -values[x] : values[x];
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+TEST_CASE("Fast Walsh-Hadamard transform", "[walsh_hadamard]")
+{
+	using namespace tweedledum;
+	std::mt19937 gen(7u);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	SimdIsa const isa
+	    = GENERATE(SimdIsa::scalar, SimdIsa::avx2, SimdIsa::avx512);
+	set_simd_isa(isa);
+	for (uint32_t num_vars = 0u; num_vars <= 10u; ++num_vars) {
+		std::vector<double> values(1u << num_vars);
+		std::vector<int32_t> integers(1u << num_vars);
+		for (uint32_t i = 0u; i < values.size(); ++i) {
+			values[i] = dist(gen);
+			integers[i] = gen() % 9;
+		}
+		std::vector<double> const expected = naive_transform(values);
+		walsh_hadamard_transform(values);
+		double error = 0.0;
+		for (uint32_t i = 0u; i < values.size(); ++i) {
+			error = std::max(error, std::abs(values[i] - expected[i]));
+		}
+		CHECK(error < 1e-10);
+
+		std::vector<int32_t> const int_expected
+		    = naive_transform(integers);
+		walsh_hadamard_transform(integers);
+		CHECK(integers == int_expected);
+	}
+	set_simd_isa(simd_isa_supported());
+}
+
+TEST_CASE("Blocked and threaded Walsh-Hadamard transform", "[walsh_hadamard]")
+{
+	using namespace tweedledum;
+	std::mt19937 gen(3u);
+	// Large enough to go through both phases and the thread pool.  Applying
+	// the transform twice multiplies the values by the size.
+	for (uint32_t num_vars : {16u, 17u}) {
+		std::vector<int64_t> values(1u << num_vars);
+		for (int64_t& value : values) {
+			value = gen() % 1000;
+		}
+		std::vector<int64_t> serial = values;
+		std::vector<int64_t> threaded = values;
+		walsh_hadamard_transform(serial, 1u);
+		walsh_hadamard_transform(threaded, 4u);
+		CHECK(serial == threaded);
+		walsh_hadamard_transform(threaded, 4u);
+		bool same = true;
+		for (uint32_t i = 0u; i < values.size(); ++i) {
+			same &= (threaded[i] == values[i] * int64_t(values.size()));
+		}
+		CHECK(same);
+	}
+}
+
+TEST_CASE("Complement variables of a function", "[walsh_hadamard]")
+{
+	using namespace tweedledum;
+	std::vector<double> values(64u);
+	for (uint32_t i = 0u; i < values.size(); ++i) {
+		values[i] = 0.5 * i;
+	}
+	std::vector<double> result(values.size());
+	for (uint64_t mask : {0u, 1u, 6u, 8u, 32u, 63u}) {
+		xor_permute(values.data(), result.data(), values.size(), mask);
+		bool same = true;
+		for (uint32_t x = 0u; x < values.size(); ++x) {
+			same &= (result[x] == values[x ^ mask]);
+		}
+		CHECK(same);
+		xor_permute(values.data(), result.data(), values.size(), mask,
+		    /* negate */ true);
+		same = true;
+		for (uint32_t x = 0u; x < values.size(); ++x) {
+			same &= (result[x] == -values[x ^ mask]);
+		}
+		CHECK(same);
+	}
+}